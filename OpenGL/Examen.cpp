@@ -9,7 +9,15 @@
 #include <learnopengl/camera.h>
 #include <learnopengl/model.h>
 
+#include <cmath>
+#include <cstdlib>
 #include <iostream>
+#include <string>
+
+#include "frame_capture.h"
+#include "shader_cache.h"
+#include "dynamic_resolution.h"
+#include "scene.h"
 
 #define STB_IMAGE_IMPLEMENTATION 
 #include <learnopengl/stb_image.h>
@@ -19,6 +27,7 @@ void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void mouse_callback(GLFWwindow* window, double xpos, double ypos);
 void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
 void processInput(GLFWwindow* window);
+void setStaticUniforms(Shader& shader, const Scene& scene, bool moonLightState);
 
 // settings
 const unsigned int SCR_WIDTH = 2200;
@@ -30,10 +39,22 @@ float lastX = SCR_WIDTH / 2.0f;
 float lastY = SCR_HEIGHT / 2.0f;
 bool firstMouse = true;
 
+// escena: modelos, instancias, luces, camaras y colisiones (--scene=<archivo>; se recarga al guardarlo)
+std::string scenePath = "scenes/estadio.json";
+Scene scene;
+
 // timing
 float deltaTime = 0.0f;
 float lastFrame = 0.0f;
 
+// captura de cuadros (--capture=png|y4m, --capture-dir=<carpeta>; tecla C graba/detiene, V cambia formato)
+std::string captureDir = "capturas";
+CaptureFormat captureFormat = CaptureFormat::PNG_SEQUENCE;
+bool captureRequested = false;
+
+// resolucion dinamica (--dynres=off, --dynres-target=<ms>, --dynres-min=<escala>; teclas - y = cambian el objetivo)
+DynamicResolutionSettings dynamicResolutionSettings;
+
 //Estructura para Semi Esferas
 struct SemiSphereCollider {
     glm::vec3 center;  // Centro de la semiesfera (x, y, z)
@@ -47,22 +68,16 @@ struct BoundingBox {
     glm::vec3 max;
 };
 
-// Coordenadas de choque
-SemiSphereCollider skydomeCollider = {
-    glm::vec3(0.0f, 0.0f, 0.0f),  // Centro del skydome
-    19.3f,                        // Radio (basado en el scale de 20.0f)
-    19.3f                         // Altura máxima hasta donde hay colisión
-};
-
-BoundingBox stadiumBoundingBox = {
-    glm::vec3(-4.80f, 0.0f, -4.20f),   // min: Esquina inferior izquierda externa (muros)
-    glm::vec3(4.80f, 1.70f, 8.10f)     // max: Esquina superior derecha externa (muros)
-};
+// Coordenadas de choque (se leen de "colliders" en el archivo de escena)
+SemiSphereCollider skydomeCollider;
+BoundingBox stadiumBoundingBox;
+BoundingBox fieldBoundingBox;
 
-BoundingBox fieldBoundingBox = {
-    glm::vec3(-1.75f, 0.0f, -1.30f),   // min: Esquina inferior izquierda interna (campo de juego)
-    glm::vec3(1.90f, 1.70f, 5.20f)     // max: Esquina superior derecha interna (campo de juego)
-};
+void applySceneColliders(const Scene& scene) {
+    skydomeCollider = { scene.colliders.skydomeCenter, scene.colliders.skydomeRadius, scene.colliders.skydomeMaxHeight };
+    stadiumBoundingBox = { scene.colliders.stadiumMin, scene.colliders.stadiumMax };
+    fieldBoundingBox = { scene.colliders.fieldMin, scene.colliders.fieldMax };
+}
 
 //Función que verifica que esté dentro
 bool checkSemiSphereCollision(glm::vec3 cameraPos, SemiSphereCollider collider) {
@@ -93,8 +108,61 @@ bool checkFieldCollision(glm::vec3 cameraPos, BoundingBox bbox) {
 //llamada a la funcion que retorna la posisicon de la camara
 void printCameraCoordinates(const Camera& camera);
 
-int main()
+// valor numerico de una opcion; false si el texto no es un numero completo (p. ej. "abc" o "12ms")
+bool parseFloatOption(const std::string& text, float& value) {
+    char* end = NULL;
+    float parsed = std::strtof(text.c_str(), &end);
+    if (text.empty() || *end != '\0' || !std::isfinite(parsed))
+        return false;
+    value = parsed;
+    return true;
+}
+
+int main(int argc, char* argv[])
 {
+    // command line
+    // ------------
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--capture=png") {
+            captureFormat = CaptureFormat::PNG_SEQUENCE;
+            captureRequested = true;
+        }
+        else if (arg == "--capture=y4m") {
+            captureFormat = CaptureFormat::Y4M_VIDEO;
+            captureRequested = true;
+        }
+        else if (arg.rfind("--scene=", 0) == 0) {
+            scenePath = arg.substr(8);
+        }
+        else if (arg.rfind("--capture-dir=", 0) == 0) {
+            captureDir = arg.substr(14);
+        }
+        else if (arg == "--dynres=off") {
+            dynamicResolutionSettings.enabled = false;
+        }
+        else if (arg.rfind("--dynres-target=", 0) == 0) {
+            // tiempo de GPU por cuadro en milisegundos, mayor que 0
+            float value = 0.0f;
+            if (parseFloatOption(arg.substr(16), value) && value > 0.0f)
+                dynamicResolutionSettings.targetFrameMs = value;
+            else
+                std::cout << "Invalid value for option: " << arg << " (expected milliseconds > 0)" << std::endl;
+        }
+        else if (arg.rfind("--dynres-min=", 0) == 0) {
+            // escala minima por eje, en (0, 1]
+            float value = 0.0f;
+            if (parseFloatOption(arg.substr(13), value) && value > 0.0f && value <= 1.0f)
+                dynamicResolutionSettings.minScale = value;
+            else
+                std::cout << "Invalid value for option: " << arg << " (expected a scale in (0, 1])" << std::endl;
+        }
+        else {
+            std::cout << "Unknown option: " << arg << std::endl;
+        }
+    }
+
     // glfw: initialize and configure
     // ------------------------------
     glfwInit();
@@ -140,23 +208,33 @@ int main()
 
     // build and compile shaders
     // -------------------------
-    Shader ourShader("shaders/shader_exercise16_mloading.vs", "shaders/shader_exercise16_mloading.fs");
+    // Los programas salen del cache de binarios (shader_cache/) y solo se compilan si cambio el codigo o el driver.
+    // Model::Draw necesita un Shader de learnopengl, que siempre compila desde el codigo fuente: se crea con un
+    // programa minimo y se le asigna el programa cacheado.
+    ShaderCache shaderCache("shader_cache");
+    Shader ourShader("shaders/program_handle.vs", "shaders/program_handle.fs");
+    glDeleteProgram(ourShader.ID);
+    ourShader.ID = shaderCache.load("shaders/shader_exercise16_mloading.vs", "shaders/shader_exercise16_mloading.fs");
     //Shader ourShaderSky("shaders/VertexsShader_TareaB2T3.vs", "shaders/FragmentShader_TareaB2T3.fs");
 
-    // load models
-    // -----------
-    Model ourModel("model/stadium/stadium2.obj");
-    Model messiModel("model/messi/messi.obj");
-    Model skydomModel("model/skydom/skydom.obj");
-    Model fireworkModel("model/firework1/firework1.obj");
-    Model fireworkModel2("model/firework2/firework2.obj");
-    Model fireworkModel3("model/firework3/firework3.obj");
-    Model fireworkModel4("model/firework4/firework4.obj");
-    Model fireworkModel5("model/firework5/firework1.obj");
-    Model terrenoModel("model/terreno/terreno.obj");
-    Model balonModel("model/balon/balon.obj");
-    Model copaModel("model/copa/copa.obj");
-    Model moonModel("model/moon/moon.obj");
+    // recarga en caliente: al guardar el .vs/.fs se recompila en segundo plano sin recargar los modelos
+    ShaderHotReload shaderReload(window, shaderCache);
+    shaderReload.watch(ourShader.ID, "shaders/shader_exercise16_mloading.vs", "shaders/shader_exercise16_mloading.fs");
+
+    // la escena se dibuja a menor resolucion cuando la GPU no alcanza el tiempo objetivo y luego se escala a la ventana
+    DynamicResolution dynamicResolution(dynamicResolutionSettings, shaderCache.load("shaders/upscale.vs", "shaders/upscale.fs"));
+    shaderReload.watch(dynamicResolution.program(), "shaders/upscale.vs", "shaders/upscale.fs");
+
+    // load scene (models, instances, lights, camera presets)
+    // -------------------------------------------------------
+    if (!scene.load(scenePath))
+    {
+        // el hilo de recarga usa un contexto compartido: se detiene antes de cerrar GLFW
+        shaderReload.shutdown();
+        glfwTerminate();
+        return -1;
+    }
+    applySceneColliders(scene);
 
 
     // draw in wireframe
@@ -166,19 +244,6 @@ int main()
     //dato camra position
     float lastPrintTime = 0.0f;
 
-    //Posiciones de los puntos de luz de la luna
-    glm::vec3 pointLightPosition = glm::vec3(10.0f, 10.0f, 1.0f);
-
-    // Reflectores del estadio
-    glm::vec3 reflectors[] = {
-        glm::vec3(1.90f, 1.22f, 5.20f),
-        glm::vec3(1.90f, 1.22f, -1.30f),
-        glm::vec3(-1.75f, 1.22f, 5.20f),
-        glm::vec3(-1.75f, 1.22f, -1.30f),
-        glm::vec3(0.0f, 1.22f, 5.20f),
-        glm::vec3(0.0f, 1.22f, -1.30f)
-    };
-
     //Cargando shader
     ourShader.use();
     ourShader.setInt("material.diffuse", 0);
@@ -188,6 +253,14 @@ int main()
 
     bool playersActivated = false;
     bool copaActivated = false;
+
+    // las luces y el material no cambian entre cuadros: solo se envian al cambiar la escena, el programa o la luna
+    bool staticUniformsDirty = true;
+    bool appliedMoonLightState = moonLightState;
+
+    //Captura de la vista principal
+    FrameCapture mainViewCapture("camara", captureDir);
+
     // render loop
     // -----------
     while (!glfwWindowShouldClose(window))
@@ -201,6 +274,8 @@ int main()
         //funcion posicion camara
         if (currentFrame - lastPrintTime >= 2.0f) {
             printCameraCoordinates(camera);
+            std::cout << "Render scale: " << dynamicResolution.getScale() << " (" << dynamicResolution.getRenderWidth() << "x" << dynamicResolution.getRenderHeight()
+                << "), GPU: " << dynamicResolution.getGpuMs() << " ms, target: " << dynamicResolutionSettings.targetFrameMs << " ms" << std::endl;
             lastPrintTime = currentFrame;
         }
 
@@ -208,91 +283,39 @@ int main()
         // -----
         processInput(window);
 
+        // shader hot reload: install programs recompiled in the background (samplers must be set again)
+        // ------------------------------------------------------------------------------------------------
+        if (shaderReload.apply()) {
+            ourShader.use();
+            ourShader.setInt("material.diffuse", 0);
+            ourShader.setInt("material.specular", 1);
+            staticUniformsDirty = true;
+        }
+
+        // scene hot reload: only newly referenced models are loaded
+        // ---------------------------------------------------------
+        if (scene.reloadIfChanged(currentFrame)) {
+            applySceneColliders(scene);
+            staticUniformsDirty = true;
+        }
+
         // render
         // ------
+        int framebufferWidth, framebufferHeight;
+        glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+        dynamicResolution.beginFrame(framebufferWidth, framebufferHeight);
+
         glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         // don't forget to enable shader before setting uniforms
         ourShader.use();
         ourShader.setVec3("viewPos", camera.Position);
-        ourShader.setFloat("material.shininess", 45.0f);
-
-        // point light - luna
-        ourShader.setVec3("pointLight.position", pointLightPosition);
-        // Dentro del bucle de renderizado, después de ourShader.use()
-        if (moonLightState) {
-            // Iluminación intensa (por ejemplo, luna llena)
-            ourShader.setVec3("pointLight.ambient", 2.0f, 1.5f, 1.0f);
-            ourShader.setVec3("pointLight.diffuse", 1.0f, 0.9f, 0.45f);
-            ourShader.setVec3("pointLight.specular", 1.5f, 1.8f, 0.75f);
+        if (staticUniformsDirty || moonLightState != appliedMoonLightState) {
+            setStaticUniforms(ourShader, scene, moonLightState);
+            appliedMoonLightState = moonLightState;
+            staticUniformsDirty = false;
         }
-        else {
-            // Iluminación tenue (por ejemplo, luna menguante)
-            ourShader.setVec3("pointLight.ambient", 0.5f, 0.5f, 0.5f);
-            ourShader.setVec3("pointLight.diffuse", 0.3f, 0.3f, 0.3f);
-            ourShader.setVec3("pointLight.specular", 0.5f, 0.5f, 0.5f);
-        }
-        ourShader.setFloat("pointLight.constant", 3.0f); // Factor de atenuacion constante de la luz: no cambia con la distancia.
-        ourShader.setFloat("pointLight.linear", 0.09); //// Factor de atenuacion lineal de la luz: atenua la luz proporcionalmente a la distancia.
-        ourShader.setFloat("pointLight.quadratic", 0.032); //// Factor de atenuacion cuadratica de la luz: atenua la luz de forma cuadratica con la distancia.
-
-        ourShader.setVec3("stadiumPointLight0.position", reflectors[0]);
-        ourShader.setVec3("stadiumPointLight0.ambient", 0.1f, 0.1f, 0.1f);
-        ourShader.setVec3("stadiumPointLight0.diffuse", 0.4f, 0.4f, 0.4f);
-        ourShader.setVec3("stadiumPointLight0.specular", 1.0f, 1.0f, 1.0f);
-        ourShader.setFloat("stadiumPointLight0.constant", 1.0f);
-        ourShader.setFloat("stadiumPointLight0.linear", 0.09f);
-        ourShader.setFloat("stadiumPointLight0.quadratic", 0.032f);
-
-        ourShader.setVec3("stadiumPointLight1.position", reflectors[1]);
-        ourShader.setVec3("stadiumPointLight1.ambient", 0.1f, 0.1f, 0.1f);
-        ourShader.setVec3("stadiumPointLight1.diffuse", 0.4f, 0.4f, 0.4f);
-        ourShader.setVec3("stadiumPointLight1.specular", 1.0f, 1.0f, 1.0f);
-        ourShader.setFloat("stadiumPointLight1.constant", 1.0f);
-        ourShader.setFloat("stadiumPointLight1.linear", 0.09f);
-        ourShader.setFloat("stadiumPointLight1.quadratic", 0.032f);
-
-        ourShader.setVec3("stadiumPointLight2.position", reflectors[2]);
-        ourShader.setVec3("stadiumPointLight2.ambient", 0.1f, 0.1f, 0.1f);
-        ourShader.setVec3("stadiumPointLight2.diffuse", 0.4f, 0.4f, 0.4f);
-        ourShader.setVec3("stadiumPointLight2.specular", 1.0f, 1.0f, 1.0f);
-        ourShader.setFloat("stadiumPointLight2.constant", 1.0f);
-        ourShader.setFloat("stadiumPointLight2.linear", 0.09f);
-        ourShader.setFloat("stadiumPointLight2.quadratic", 0.032f);
-
-        ourShader.setVec3("stadiumPointLight3.position", reflectors[3]);
-        ourShader.setVec3("stadiumPointLight3.ambient", 0.1f, 0.1f, 0.1f);
-        ourShader.setVec3("stadiumPointLight3.diffuse", 0.4f, 0.4f, 0.4f);
-        ourShader.setVec3("stadiumPointLight3.specular", 1.0f, 1.0f, 1.0f);
-        ourShader.setFloat("stadiumPointLight3.constant", 1.0f);
-        ourShader.setFloat("stadiumPointLight3.linear", 0.09f);
-        ourShader.setFloat("stadiumPointLight3.quadratic", 0.032f);
-
-        ourShader.setVec3("stadiumPointLight4.position", reflectors[4]);
-        ourShader.setVec3("stadiumPointLight4.ambient", 0.1f, 0.1f, 0.1f);
-        ourShader.setVec3("stadiumPointLight4.diffuse", 0.4f, 0.4f, 0.4f);
-        ourShader.setVec3("stadiumPointLight4.specular", 1.0f, 1.0f, 1.0f);
-        ourShader.setFloat("stadiumPointLight4.constant", 1.0f);
-        ourShader.setFloat("stadiumPointLight4.linear", 0.09f);
-        ourShader.setFloat("stadiumPointLight4.quadratic", 0.032f);
-
-        ourShader.setVec3("stadiumPointLight5.position", reflectors[5]);
-        ourShader.setVec3("stadiumPointLight5.ambient", 0.1f, 0.1f, 0.1f);
-        ourShader.setVec3("stadiumPointLight5.diffuse", 0.4f, 0.4f, 0.4f);
-        ourShader.setVec3("stadiumPointLight5.specular", 1.0f, 1.0f, 1.0f);
-        ourShader.setFloat("stadiumPointLight5.constant", 1.0f);
-        ourShader.setFloat("stadiumPointLight5.linear", 0.09f);
-        ourShader.setFloat("stadiumPointLight5.quadratic", 0.032f);
-
-
-        ourShader.setVec3("spotLight.ambient", 0.0f, 0.0f, 0.0f);
-        ourShader.setVec3("spotLight.diffuse", 0.0f, 0.0f, 0.0f);
-        ourShader.setVec3("spotLight.specular", 0.0f, 0.0f, 0.0f);
-        ourShader.setFloat("spotLight.constant", 0.5f); //Atenuacion de la luz  
-        ourShader.setFloat("spotLight.linear", 0.05);
-        ourShader.setFloat("spotLight.quadratic", 0.5);
-
 
         // view/projection transformations
         glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
@@ -300,24 +323,8 @@ int main()
         ourShader.setMat4("projection", projection);
         ourShader.setMat4("view", view);
 
-        // render the loaded model
-        //Stadium
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, glm::vec3(2.3f, 0.0f, 2.0f)); // translate it down so it's at the center of the scene
-        model = glm::scale(model, glm::vec3(1.0f, 1.0f, 1.0f));	// it's a bit too big for our scene, so scale it down
-        model = glm::rotate(model, glm::radians(-90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-        ourShader.setMat4("model", model);
-        ourModel.Draw(ourShader);
-
-        //Terreno
-        glm::mat4 modelTerreno = glm::mat4(1.0f);
-        modelTerreno = glm::translate(modelTerreno, glm::vec3(0.0f, -0.8f, -10.0f)); // translate it down so it's at the center of the scene
-        modelTerreno = glm::scale(modelTerreno, glm::vec3(50.0f, 50.0f, 50.0f));	// it's a bit too big for our scene, so scale it down
-        ourShader.setMat4("model", modelTerreno);
-        terrenoModel.Draw(ourShader);
-
-        //Players
-
+        // render the scene: static world matrices are cached, only animated nodes are recomputed
+        // -----------------------------------------------------------------------------------------
         if (glfwGetKey(window, GLFW_KEY_2) == GLFW_PRESS) {
             if (playersActivated) {
                 playersActivated = false;
@@ -327,87 +334,19 @@ int main()
             }
         }
 
-        if (playersActivated) {
-
-            float altura = 0.05f * sin(10.0f * currentFrame);  // Funci n senoidal para la altura
-
-            //balon
-         // 
-
-            glm::mat4 modelBalon = glm::mat4(1.0f);
-            modelBalon = glm::translate(modelBalon, glm::vec3(0.229368f, 0.0f, 1.97711f)); // translate it down so it's at the center of the scene
-            modelBalon = glm::scale(modelBalon, glm::vec3(0.05f, 0.05f, 0.05f));	// it's a bit too big for our scene, so scale it down
-            ourShader.setMat4("model", modelBalon);
-            balonModel.Draw(ourShader);
-
-            glm::mat4 modelMessi = glm::mat4(1.0f);
-            modelMessi = glm::translate(modelMessi, glm::vec3(0.117488f, 0.0f, 2.1629f)); // translate it down so it's at the center of the scene
-            modelMessi = glm::rotate(modelMessi, glm::radians(180.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-            modelMessi = glm::scale(modelMessi, glm::vec3(0.0012f, 0.0012f, 0.0012f));	// it's a bit too big for our scene, so scale it down
-            ourShader.setMat4("model", modelMessi);
-            messiModel.Draw(ourShader);
-
-            glm::mat4 modelMessi1 = glm::mat4(1.0f);
-            modelMessi1 = glm::translate(modelMessi1, glm::vec3(0.228094f, 0.0f, 4.38508f)); // translate it down so it's at the center of the scene
-            modelMessi1 = glm::rotate(modelMessi1, glm::radians(180.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-            modelMessi1 = glm::scale(modelMessi1, glm::vec3(0.0012f, 0.0012f, 0.0012f));	// it's a bit too big for our scene, so scale it down
-            ourShader.setMat4("model", modelMessi1);
-            messiModel.Draw(ourShader);
-
-
-
-            for (unsigned int i = 0; i < 2; i++)
-            {
-                for (unsigned j = 0; j < 4; j++)
-                {
-                    glm::mat4 modelMessi2 = glm::mat4(1.0f);
-                    modelMessi2 = glm::translate(modelMessi2, glm::vec3(-1.15691f + j, altura, 3.87968f - i));
-                    modelMessi2 = glm::rotate(modelMessi2, glm::radians(180.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-                    modelMessi2 = glm::scale(modelMessi2, glm::vec3(0.0012f, 0.0012f, 0.0012f));
-                    ourShader.setMat4("model", modelMessi2);
-                    messiModel.Draw(ourShader);
-                }
-
-            }
-
-            for (unsigned int i = 0; i < 2; i++)
-            {
-                for (unsigned j = 0; j < 4; j++)
-                {
-                    glm::mat4 modelMessi3 = glm::mat4(1.0f);
-                    modelMessi3 = glm::translate(modelMessi3, glm::vec3(-1.06649 + j, altura, 0.108762 + i));
-                    //modelMessi2 = glm::rotate(modelMessi2, glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-                    modelMessi3 = glm::scale(modelMessi3, glm::vec3(0.0012f, 0.0012f, 0.0012f));
-                    ourShader.setMat4("model", modelMessi3);
-                    messiModel.Draw(ourShader);
-                }
-
+        if (glfwGetKey(window, GLFW_KEY_3) == GLFW_PRESS) {
+            if (copaActivated) {
+                copaActivated = false;
             }
-
-            glm::mat4 modelMessi4 = glm::mat4(1.0f);
-            modelMessi4 = glm::translate(modelMessi4, glm::vec3(0.0881392f, 0.0f, -0.396865f)); // translate it down so it's at the center of the scene
-            modelMessi4 = glm::scale(modelMessi4, glm::vec3(0.0012f, 0.0012f, 0.0012f));	// it's a bit too big for our scene, so scale it down
-            ourShader.setMat4("model", modelMessi4);
-            messiModel.Draw(ourShader);
-
-            for (unsigned i = 0; i < 2; i++)
-            {
-                glm::mat4 modelMessi3 = glm::mat4(1.0f);
-                modelMessi3 = glm::translate(modelMessi3, glm::vec3(-0.0881392 + i, 0.0f, 1.65189f));
-                //modelMessi2 = glm::rotate(modelMessi2, glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-                modelMessi3 = glm::scale(modelMessi3, glm::vec3(0.0012f, 0.0012f, 0.0012f));
-                ourShader.setMat4("model", modelMessi3);
-                messiModel.Draw(ourShader);
+            else {
+                copaActivated = true;
             }
         }
 
-        //Sky
-
-        glm::mat4 modelSkydom = glm::mat4(1.0f);
-        modelSkydom = glm::translate(modelSkydom, glm::vec3(0.0f, 0.0f, 0.0f)); // translate it down so it's at the center of the scene
-        modelSkydom = glm::scale(modelSkydom, glm::vec3(20.0f, 20.0f, 20.0f));	// it's a bit too big for our scene, so scale it down
-        ourShader.setMat4("model", modelSkydom);
-        skydomModel.Draw(ourShader);
+        scene.setGroupVisible("players", playersActivated);
+        scene.setGroupVisible("copa", copaActivated);
+        scene.update(currentFrame);
+        scene.draw(ourShader);
 
         //Fireworks
         //al mantener presionada la tecla 1 aparecen los juegos pirotecnicos
@@ -422,95 +361,24 @@ int main()
             activated = true;
             startTime = glfwGetTime();
         }
-        // Fuegos artificiales
+        // Fuegos artificiales: cada fase dura phaseDuration segundos y usa sus propias posiciones
+        const FireworkShow& show = scene.fireworks;
         if (activated) {
-            float initialSize = 0.1f;  // Tamaño inicial de los modelos
-
-            if (elapsedTime >= 0 && elapsedTime < 4) {
-                float maxTime = 4.0f;  // Duración de la fase
-                float startOfPhase = 0.0f;
-                float delays[5] = { 0.0f, 0.9f, 1.6f, 2.9f, 4.2f };
-                glm::vec3 positions[5] = {
-                    glm::vec3(-3.66f, 3.03f, 4.48f),
-                    glm::vec3(3.66f, 3.03f, 4.48f),
-                    glm::vec3(3.66f, 3.03f, 0.15f),
-                    glm::vec3(-3.66f, 3.03f, 0.15f),
-                    glm::vec3(0.66769f, 3.03, 2.055f)
-                };
-
-                Model fireworkModels[5] = { fireworkModel, fireworkModel2, fireworkModel3, fireworkModel4, fireworkModel5 };
-
-                for (int i = 0; i < 5; i++) {
-                    if (elapsedTime > delays[i]) {
-                        float adjustedTime = elapsedTime - startOfPhase - delays[i];
-                        float scaleFactor = initialSize + (adjustedTime / maxTime) * 0.2f; // Ahora crece correctamente
+            int phase = (int)(elapsedTime / show.phaseDuration);
+            if (elapsedTime >= 0 && phase < (int)show.phases.size()) {
+                float startOfPhase = phase * show.phaseDuration;
 
-                        glm::mat4 model = glm::mat4(1.0f);
-                        model = glm::translate(model, positions[i]);
-                        model = glm::scale(model, glm::vec3(scaleFactor));
-
-                        ourShader.setMat4("model", model);
-                        fireworkModels[i].Draw(ourShader);
-                        moonLightState = !moonLightState;
-                    }
-                }
-            }
-
-            else if (elapsedTime >= 4 && elapsedTime < 8) {
-                float maxTime = 4.0f;
-                float startOfPhase = 4.0f;
-                float delays[5] = { 0.0f, 0.9f, 1.6f, 2.9f, 4.2f };
-                glm::vec3 positions[5] = {
-                    glm::vec3(2.66f, 3.03f, 3.48f),
-                    glm::vec3(2.66f, 3.03f, 1.15f),
-                    glm::vec3(-2.66f, 3.03f, 3.48f),
-                    glm::vec3(-2.66f, 3.03f, 1.15f),
-                    glm::vec3(0.66769f, 3.03, 2.055f)
-                };
-
-                Model fireworkModels[5] = { fireworkModel, fireworkModel2, fireworkModel3, fireworkModel4, fireworkModel5 };
-
-                for (int i = 0; i < 5; i++) {
-                    if (elapsedTime > delays[i]) {
-                        float adjustedTime = elapsedTime - startOfPhase - delays[i];
-                        float scaleFactor = initialSize + (adjustedTime / maxTime) * 0.2f;
+                for (size_t i = 0; i < show.models.size(); i++) {
+                    if (elapsedTime > show.delays[i]) {
+                        float adjustedTime = elapsedTime - startOfPhase - show.delays[i];
+                        float scaleFactor = show.initialSize + (adjustedTime / show.phaseDuration) * show.growth; // Ahora crece correctamente
 
                         glm::mat4 model = glm::mat4(1.0f);
-                        model = glm::translate(model, positions[i]);
+                        model = glm::translate(model, show.phases[phase][i]);
                         model = glm::scale(model, glm::vec3(scaleFactor));
 
                         ourShader.setMat4("model", model);
-                        fireworkModels[i].Draw(ourShader);
-                        moonLightState = !moonLightState;
-                    }
-                }
-            }
-
-            else if (elapsedTime >= 8 && elapsedTime < 12) {
-                float maxTime = 4.0f;
-                float startOfPhase = 8.0f;
-                float delays[5] = { 0.0f, 0.9f, 1.6f, 2.9f, 4.2f };
-                glm::vec3 positions[5] = {
-                    glm::vec3(0.66769f, 3.03, 2.055f),
-                    glm::vec3(3.66f, 3.03f, 0.15f),
-                    glm::vec3(-3.66f, 3.03f, 0.15f),
-                    glm::vec3(-3.66f, 3.03f, 4.48f),
-                    glm::vec3(3.66f, 3.03f, 4.48f)
-                };
-
-                Model fireworkModels[5] = { fireworkModel, fireworkModel2, fireworkModel3, fireworkModel4, fireworkModel5 };
-
-                for (int i = 0; i < 5; i++) {
-                    if (elapsedTime > delays[i]) {
-                        float adjustedTime = elapsedTime - startOfPhase - delays[i];
-                        float scaleFactor = initialSize + (adjustedTime / maxTime) * 0.2f;
-
-                        glm::mat4 model = glm::mat4(1.0f);
-                        model = glm::translate(model, positions[i]);
-                        model = glm::scale(model, glm::vec3(scaleFactor));
-
-                        ourShader.setMat4("model", model);
-                        fireworkModels[i].Draw(ourShader);
+                        show.models[i]->Draw(ourShader);
                         moonLightState = !moonLightState;
                     }
                 }
@@ -521,49 +389,22 @@ int main()
             }
         }
 
-        //balon
-        // 
-
-        glm::mat4 modelBalon = glm::mat4(1.0f);
-        modelBalon = glm::translate(modelBalon, glm::vec3(0.229368f, 0.0f, 1.97711f)); // translate it down so it's at the center of the scene
-        modelBalon = glm::scale(modelBalon, glm::vec3(0.05f, 0.05f, 0.05f));	// it's a bit too big for our scene, so scale it down
-        ourShader.setMat4("model", modelBalon);
-        balonModel.Draw(ourShader);
+        // upscale the scene to the window
+        dynamicResolution.endFrame();
 
-        //copa
-        
-        if (glfwGetKey(window, GLFW_KEY_3) == GLFW_PRESS) {
-            if (copaActivated) {
-                copaActivated = false;
-            }
-            else {
-                copaActivated = true;
-            }
+        // frame capture: queue an asynchronous readback of the finished frame (never waits on the GPU or the disk)
+        // -------------------------------------------------------------------------------------------------------
+        if (captureRequested && (!mainViewCapture.isRecording() || mainViewCapture.getFormat() != captureFormat)) {
+            mainViewCapture.stop();
+            // si no se puede iniciar (p. ej. la carpeta no se pudo crear) no se reintenta cada cuadro
+            if (!mainViewCapture.start(captureFormat))
+                captureRequested = false;
         }
-
-        if (copaActivated) {
-
-            float angulo = currentFrame * glm::radians(45.0f);
-
-            glm::mat4 modelCopa = glm::mat4(1.0f);
-            // Traslada el modelo a la posici n base, utilizando la posici n din mica en Y
-            modelCopa = glm::translate(modelCopa, glm::vec3(0.229368f, 0.0f, 1.97711f));
-            // Rota el modelo alrededor del eje Y
-            modelCopa = glm::rotate(modelCopa, angulo, glm::vec3(0.0f, 1.0f, 0.0f));
-            // Escala el modelo
-            modelCopa = glm::scale(modelCopa, glm::vec3(0.08f, 0.08f, 0.08f));
-
-            ourShader.setMat4("model", modelCopa);
-            copaModel.Draw(ourShader);
-
+        else if (!captureRequested && mainViewCapture.isRecording()) {
+            mainViewCapture.stop();
         }
-
-        //Luna
-        model = glm::mat4(1.0f);
-        model = glm::translate(model, glm::vec3(10.0f, 10.0f, 1.0f)); //en lo alto, por eso se cambia y a 10
-        model = glm::scale(model, glm::vec3(0.3f, 0.3f, 0.3f));
-        ourShader.setMat4("model", model);
-        moonModel.Draw(ourShader);
+        // tambien sin grabar: recoge las lecturas que quedaron en vuelo al detener
+        mainViewCapture.capture(0, 0, framebufferWidth, framebufferHeight);
 
         // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
         // -------------------------------------------------------------------------------
@@ -572,6 +413,10 @@ int main()
     }
     //---------------------------------------------------------------------
 
+    // flush pending captures while the context is still alive
+    mainViewCapture.shutdown();
+    shaderReload.shutdown();
+
         // glfw: terminate, clearing all previously allocated GLFW resources.
         // ------------------------------------------------------------------
     glfwTerminate();
@@ -641,57 +486,39 @@ void processInput(GLFWwindow* window)
     }
 
 
-    // Si presiona "1", mueve la cámara y la bloquea
-    if (glfwGetKey(window, GLFW_KEY_1) == GLFW_PRESS)
+    // Si presiona una tecla de camara predefinida (archivo de escena), mueve la cámara y la bloquea
+    for (const CameraPreset& preset : scene.cameraPresets)
     {
-        camera.Position = glm::vec3(-7.87f, 3.78f, 12.33f); // NUEVA POSICIÓN DE LA CÁMARA
-        camera.Front = glm::normalize(glm::vec3(0.625f, 0.02f, -0.78f)); // DIRECCIÓN A LA QUE APUNTA
-    }
-
-    glm::vec3 centerPosition = glm::vec3(0.0f, 0.0f, 3.0f); // Define el punto central de la escena
-
-    // Si presiona "9", mueve la cámara y la bloquea
-    if (glfwGetKey(window, GLFW_KEY_9) == GLFW_PRESS)
-    {
-        camera.Position = glm::vec3(0.0f, 10.0f, 3.0f);
-        camera.Front = glm::normalize(centerPosition - camera.Position);
-
-    }
-
-    // Si presiona "8", mueve la cámara y la bloquea
-    if (glfwGetKey(window, GLFW_KEY_8) == GLFW_PRESS)
-    {
-        camera.Position = glm::vec3(1.90f, 1.22f, 5.20f);
-        camera.Front = glm::normalize(centerPosition - camera.Position);
-    }
-
-    // Si presiona "7", mueve la cámara y la bloquea
-    if (glfwGetKey(window, GLFW_KEY_7) == GLFW_PRESS)
-    {
-        camera.Position = glm::vec3(1.90f, 1.22f, -1.30f);
-        camera.Front = glm::normalize(centerPosition - camera.Position);
-    }
-
-    // Si presiona "6", mueve la cámara y la bloquea
-    if (glfwGetKey(window, GLFW_KEY_6) == GLFW_PRESS)
-    {
-        camera.Position = glm::vec3(-1.75f, 1.22f, 5.20f);
-        camera.Front = glm::normalize(centerPosition - camera.Position);
+        if (glfwGetKey(window, GLFW_KEY_0 + preset.key) == GLFW_PRESS)
+        {
+            camera.Position = preset.position;
+            camera.Front = preset.front;
+        }
     }
 
-    // Si presiona "5", mueve la cámara y la bloquea
-    if (glfwGetKey(window, GLFW_KEY_5) == GLFW_PRESS)
-    {
-        camera.Position = glm::vec3(-1.75f, 1.22f, -1.30f);
-        camera.Front = glm::normalize(centerPosition - camera.Position);
+    // Si presiona "C", inicia o detiene la captura de cuadros (se detecta solo el flanco de la tecla)
+    static bool captureKeyPressed = false;
+    if (glfwGetKey(window, GLFW_KEY_C) == GLFW_PRESS && !captureKeyPressed)
+        captureRequested = !captureRequested;
+    captureKeyPressed = glfwGetKey(window, GLFW_KEY_C) == GLFW_PRESS;
+
+    // Si presiona "V", alterna entre secuencia PNG y video Y4M
+    static bool formatKeyPressed = false;
+    if (glfwGetKey(window, GLFW_KEY_V) == GLFW_PRESS && !formatKeyPressed) {
+        captureFormat = captureFormat == CaptureFormat::PNG_SEQUENCE ? CaptureFormat::Y4M_VIDEO : CaptureFormat::PNG_SEQUENCE;
+        std::cout << "Capture format: " << (captureFormat == CaptureFormat::PNG_SEQUENCE ? "PNG" : "Y4M") << std::endl;
     }
-
-    // Si presiona "4", mueve la cámara y la bloquea
-    if (glfwGetKey(window, GLFW_KEY_4) == GLFW_PRESS)
-    {
-        camera.Position = glm::vec3(0.0f, 1.22f, 5.20f);
-        camera.Front = glm::normalize(centerPosition - camera.Position);
+    formatKeyPressed = glfwGetKey(window, GLFW_KEY_V) == GLFW_PRESS;
+
+    // Teclas "-" y "=": bajan o suben el tiempo objetivo de GPU de la resolucion dinamica
+    static bool targetKeyPressed = false;
+    bool lowerTarget = glfwGetKey(window, GLFW_KEY_MINUS) == GLFW_PRESS;
+    bool raiseTarget = glfwGetKey(window, GLFW_KEY_EQUAL) == GLFW_PRESS;
+    if ((lowerTarget || raiseTarget) && !targetKeyPressed) {
+        dynamicResolutionSettings.targetFrameMs = glm::clamp(dynamicResolutionSettings.targetFrameMs + (raiseTarget ? 1.0f : -1.0f), 2.0f, 50.0f);
+        std::cout << "Dynamic resolution target: " << dynamicResolutionSettings.targetFrameMs << " ms" << std::endl;
     }
+    targetKeyPressed = lowerTarget || raiseTarget;
 }
 
 // glfw: whenever the window size changed (by OS or user resize) this callback function executes
@@ -730,6 +557,31 @@ void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
     camera.ProcessMouseScroll(yoffset);
 }
 
+// luces de la escena, material y linterna: se envian solo cuando cambian
+void setStaticUniforms(Shader& shader, const Scene& scene, bool moonLightState)
+{
+    shader.setFloat("material.shininess", 45.0f);
+
+    for (const SceneLight& light : scene.lights) {
+        // la luz con valores "flash" (la luna) se intensifica con los fuegos artificiales
+        bool flash = light.hasFlash && moonLightState;
+        shader.setVec3(light.uniform + ".position", light.position);
+        shader.setVec3(light.uniform + ".ambient", flash ? light.flashAmbient : light.ambient);
+        shader.setVec3(light.uniform + ".diffuse", flash ? light.flashDiffuse : light.diffuse);
+        shader.setVec3(light.uniform + ".specular", flash ? light.flashSpecular : light.specular);
+        shader.setFloat(light.uniform + ".constant", light.constant);
+        shader.setFloat(light.uniform + ".linear", light.linear);
+        shader.setFloat(light.uniform + ".quadratic", light.quadratic);
+    }
+
+    shader.setVec3("spotLight.ambient", 0.0f, 0.0f, 0.0f);
+    shader.setVec3("spotLight.diffuse", 0.0f, 0.0f, 0.0f);
+    shader.setVec3("spotLight.specular", 0.0f, 0.0f, 0.0f);
+    shader.setFloat("spotLight.constant", 0.5f); //Atenuacion de la luz  
+    shader.setFloat("spotLight.linear", 0.05);
+    shader.setFloat("spotLight.quadratic", 0.5);
+}
+
 //funcion camara position
 void printCameraCoordinates(const Camera& camera) {
     glm::vec3 position = camera.Position;
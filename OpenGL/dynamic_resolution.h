@@ -0,0 +1,234 @@
+#ifndef DYNAMIC_RESOLUTION_H
+#define DYNAMIC_RESOLUTION_H
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// Parametros de ajuste (linea de comandos y teclas - / =)
+struct DynamicResolutionSettings {
+    bool enabled = true;
+    float targetFrameMs = 15.0f;   // presupuesto de GPU por cuadro, con margen bajo 16.6 ms (60 fps)
+    float minScale = 0.5f;         // escala minima por eje respecto a la ventana
+    float maxScale = 1.0f;
+};
+
+// Resolucion dinamica.
+// La escena se dibuja en un framebuffer propio a una fraccion de la resolucion de la ventana; la fraccion
+// se ajusta cada cuadro con el tiempo de GPU medido por queries GL_TIME_ELAPSED (leidas con unos cuadros
+// de retraso para no esperar a la GPU). Al final se escala a la ventana con un filtro Catmull-Rom.
+// Los buffers se reservan al tamano de la ventana y solo se usa la parte que corresponde a la escala,
+// asi que cambiar la escala no reasigna memoria.
+class DynamicResolution
+{
+public:
+    DynamicResolution(DynamicResolutionSettings& settings, unsigned int upscaleProgram)
+        : settings(settings), upscaleProgram(upscaleProgram)
+    {
+        glGenFramebuffers(1, &framebuffer);
+        glGenTextures(1, &colorTexture);
+        glGenRenderbuffers(1, &depthBuffer);
+        glGenVertexArrays(1, &emptyVAO);
+        glGenQueries(QUERY_COUNT, queries);
+    }
+
+    float getScale() const { return scale; }
+    float getGpuMs() const { return gpuMs; }
+    int getRenderWidth() const { return renderWidth; }
+    int getRenderHeight() const { return renderHeight; }
+
+    // programa de escalado, expuesto para la recarga en caliente
+    unsigned int& program() { return upscaleProgram; }
+
+    // antes de dibujar la escena: mide, ajusta la escala y deja activo el framebuffer de la escena
+    // (ventana minimizada: framebuffer de 0x0, no se mide ni se escala y endFrame() no hace nada)
+    void beginFrame(int windowWidth, int windowHeight)
+    {
+        frameActive = false;
+        timing = false;
+        if (windowWidth <= 0 || windowHeight <= 0)
+            return;
+        if (windowWidth != outputWidth || windowHeight != outputHeight)
+            resize(windowWidth, windowHeight);
+
+        readTimings();
+        updateScale();
+
+        // una sola query GL_TIME_ELAPSED puede estar activa; si la de este turno aun no tiene resultado se omite la medicion
+        timing = !issued[current] || resultAvailable(queries[current]);
+        if (timing)
+            glBeginQuery(GL_TIME_ELAPSED, queries[current]);
+
+        if (settings.enabled)
+        {
+            renderWidth = std::max(1, (int)std::lround(outputWidth * scale));
+            renderHeight = std::max(1, (int)std::lround(outputHeight * scale));
+            glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        }
+        else
+        {
+            renderWidth = outputWidth;
+            renderHeight = outputHeight;
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        }
+        glViewport(0, 0, renderWidth, renderHeight);
+        frameActive = true;
+    }
+
+    // despues de dibujar la escena: escala a la ventana y deja activo el framebuffer por defecto
+    void endFrame()
+    {
+        if (!frameActive)
+            return;
+        frameActive = false;
+
+        if (settings.enabled)
+            upscale();
+
+        if (timing)
+        {
+            glEndQuery(GL_TIME_ELAPSED);
+            issued[current] = true;
+            current = (current + 1) % QUERY_COUNT;
+        }
+    }
+
+private:
+    static const int QUERY_COUNT = 4;
+
+    DynamicResolutionSettings& settings;
+    unsigned int upscaleProgram;
+
+    GLuint framebuffer = 0;
+    GLuint colorTexture = 0;
+    GLuint depthBuffer = 0;
+    GLuint emptyVAO = 0;
+    GLuint queries[QUERY_COUNT];
+    bool issued[QUERY_COUNT] = { false, false, false, false };
+    int current = 0;
+    bool timing = false;
+    bool frameActive = false;
+
+    int outputWidth = 0;
+    int outputHeight = 0;
+    int renderWidth = 0;
+    int renderHeight = 0;
+    float scale = 1.0f;
+    float gpuMs = 0.0f;
+    bool newSample = false;
+
+    void resize(int width, int height)
+    {
+        outputWidth = width;
+        outputHeight = height;
+
+        // la textura es el destino del render: no debe quedar ligada para que los modelos no la lean
+        GLint previousTexture = 0;
+        glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture);
+        glBindTexture(GL_TEXTURE_2D, colorTexture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, previousTexture);
+
+        glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        {
+            std::cout << "ERROR::FRAMEBUFFER:: Dynamic resolution framebuffer is not complete, rendering at full resolution" << std::endl;
+            settings.enabled = false;
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    static bool resultAvailable(GLuint query)
+    {
+        GLuint available = 0;
+        glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        return available != 0;
+    }
+
+    // lee sin bloquear las mediciones que ya termino la GPU
+    void readTimings()
+    {
+        for (int i = 1; i <= QUERY_COUNT; i++)
+        {
+            int slot = (current + i) % QUERY_COUNT;
+            if (!issued[slot] || !resultAvailable(queries[slot]))
+                continue;
+            GLuint64 nanoseconds = 0;
+            glGetQueryObjectui64v(queries[slot], GL_QUERY_RESULT, &nanoseconds);
+            issued[slot] = false;
+
+            float ms = nanoseconds / 1000000.0f;
+            gpuMs = gpuMs == 0.0f ? ms : gpuMs * 0.75f + ms * 0.25f;
+            newSample = true;
+        }
+    }
+
+    void updateScale()
+    {
+        if (!settings.enabled)
+        {
+            scale = 1.0f;
+            return;
+        }
+        float minScale = std::min(settings.minScale, settings.maxScale);
+        if (newSample && gpuMs > 0.0f)
+        {
+            newSample = false;
+            // el costo de la escena crece con el area, es decir con scale^2; se baja rapido y se sube despacio,
+            // con una banda muerta para que la escala no oscile
+            if (gpuMs > settings.targetFrameMs || gpuMs < settings.targetFrameMs * 0.85f)
+            {
+                float desired = scale * std::sqrt(settings.targetFrameMs / gpuMs);
+                scale += std::max(-0.05f, std::min(desired - scale, 0.01f));
+            }
+        }
+        scale = std::max(minScale, std::min(scale, settings.maxScale));
+    }
+
+    void upscale()
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, outputWidth, outputHeight);
+
+        // a escala completa basta con copiar; sin el shader de escalado (no compilo) se usa un filtro bilineal
+        bool fullScale = renderWidth == outputWidth && renderHeight == outputHeight;
+        if (fullScale || upscaleProgram == 0)
+        {
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+            glBlitFramebuffer(0, 0, renderWidth, renderHeight, 0, 0, outputWidth, outputHeight, GL_COLOR_BUFFER_BIT, fullScale ? GL_NEAREST : GL_LINEAR);
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            return;
+        }
+
+        glDisable(GL_DEPTH_TEST);
+        glUseProgram(upscaleProgram);
+        glUniform1i(glGetUniformLocation(upscaleProgram, "sourceTexture"), 0);
+        glUniform2f(glGetUniformLocation(upscaleProgram, "textureSize"), (float)outputWidth, (float)outputHeight);
+        glUniform2f(glGetUniformLocation(upscaleProgram, "renderSize"), (float)renderWidth, (float)renderHeight);
+
+        // se restaura la textura de la unidad 0: si colorTexture quedara ligada, los meshes sin textura difusa
+        // la leerian mientras se dibuja en ella el siguiente cuadro (feedback loop)
+        GLint previousTexture = 0;
+        glActiveTexture(GL_TEXTURE0);
+        glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture);
+        glBindTexture(GL_TEXTURE_2D, colorTexture);
+        glBindVertexArray(emptyVAO);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        glBindVertexArray(0);
+        glBindTexture(GL_TEXTURE_2D, previousTexture);
+        glEnable(GL_DEPTH_TEST);
+    }
+};
+
+#endif
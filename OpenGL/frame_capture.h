@@ -0,0 +1,570 @@
+#ifndef FRAME_CAPTURE_H
+#define FRAME_CAPTURE_H
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Formatos de salida de la captura
+enum class CaptureFormat {
+    PNG_SEQUENCE,   // un archivo .png por cuadro
+    Y4M_VIDEO       // video YUV 4:2:0 sin comprimir (.y4m) a 60 fps fijos, lo abren ffmpeg/mpv/VLC
+};
+
+// Captura de cuadros sin detener el render.
+// glReadPixels escribe en un anillo de PBOs y cada lectura queda marcada con un fence;
+// el cuadro solo se mapea cuando su fence ya se cumplio, y la codificacion se hace en hilos
+// de trabajo. Si la GPU o el disco no alcanzan, el cuadro se descarta en lugar de esperar.
+// Detener o cambiar de formato tampoco espera: las lecturas en vuelo se recogen en los cuadros
+// siguientes y los hilos, que viven mientras exista la instancia, terminan de escribir la sesion
+// anterior mientras ya se graba la nueva.
+// Se usa una instancia por vista (camara) cuando hay varias en pantalla.
+// El render no va a una tasa fija, asi que cada cuadro guarda la hora en que se capturo: la secuencia PNG
+// conserva todos los cuadros recibidos, y el video se remuestrea a 60 fps con esa hora (se repite el
+// cuadro anterior donde faltan cuadros y se omiten los que caen en un cuadro ya escrito) para que se
+// reproduzca a la velocidad real.
+class FrameCapture
+{
+public:
+    FrameCapture(const std::string& name, const std::string& outputDir, unsigned int ringSize = 3)
+        : name(name), outputDir(outputDir), slots(ringSize < 2 ? 2 : ringSize)
+    {
+    }
+
+    // shutdown() debe llamarse antes de destruir el contexto OpenGL; aqui solo se cierran los hilos
+    ~FrameCapture()
+    {
+        finishWorkers();
+    }
+
+    bool isRecording() const { return current != nullptr; }
+    CaptureFormat getFormat() const { return current ? current->format : CaptureFormat::PNG_SEQUENCE; }
+    unsigned long getFramesWritten() const { return current ? current->framesWritten.load() : 0; }
+    unsigned long getFramesDropped() const { return current ? current->framesDropped.load() : 0; }
+
+    // inicia una nueva sesion de captura (nuevos archivos, no sobreescribe las anteriores); false si no se pudo iniciar
+    bool start(CaptureFormat captureFormat)
+    {
+        if (current)
+            return true;
+
+        std::error_code error;
+        std::filesystem::create_directories(outputDir, error);
+        if (error)
+        {
+            std::cout << "ERROR::CAPTURE::CANNOT_CREATE_DIRECTORY " << outputDir << ": " << error.message() << std::endl;
+            return false;
+        }
+
+        // milisegundos desde 1970, nunca repetidos dentro de la misma instancia: detener y volver a grabar
+        // en el mismo segundo (C dos veces, o V dos veces mientras se graba) no reescribe la sesion anterior
+        long long now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        lastSession = std::max(now, lastSession + 1);
+
+        current = std::make_shared<Session>();
+        current->prefix = (std::filesystem::path(outputDir) / (name + "_" + std::to_string(lastSession))).string();
+        current->format = captureFormat;
+        frameIndex = 0;
+
+        // el anillo se conserva entre sesiones; sus PBOs se liberan en shutdown()
+        for (Slot& slot : slots)
+        {
+            if (slot.pbo == 0)
+            {
+                glGenBuffers(1, &slot.pbo);
+                slot.size = 0;
+            }
+        }
+        startWorkers(captureFormat);
+
+        std::cout << "Capture started: " << current->prefix << (captureFormat == CaptureFormat::Y4M_VIDEO ? ".y4m" : "_*.png") << std::endl;
+        return true;
+    }
+
+    // termina la sesion sin esperar: los cuadros pendientes se escriben en segundo plano y el total
+    // se informa cuando la sesion termina de escribirse
+    void stop()
+    {
+        if (!current)
+            return;
+        std::cout << "Capture stopped: " << current->prefix << " (finishing queued frames in background)" << std::endl;
+        current.reset();
+    }
+
+    // al cerrar, con el contexto aun vivo: espera las lecturas y las escrituras pendientes y libera los PBOs
+    void shutdown()
+    {
+        stop();
+        while (!inFlight.empty())
+        {
+            Slot& slot = slots[inFlight.front()];
+            glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+            readBack(slot);
+            inFlight.pop_front();
+        }
+        for (Slot& slot : slots)
+        {
+            glDeleteBuffers(1, &slot.pbo);
+            slot.pbo = 0;
+        }
+        finishWorkers();
+    }
+
+    // llamar cada cuadro, despues de dibujar la vista y antes de glfwSwapBuffers (tambien sin grabar, para
+    // recoger las lecturas de una sesion detenida); x, y, width, height es el viewport de la vista
+    void capture(int x, int y, int width, int height)
+    {
+        collectReady();
+        if (!current || width <= 0 || height <= 0)
+            return;
+
+        // el anillo esta lleno y la GPU aun no termina la lectura mas antigua: se pierde este cuadro
+        Slot& slot = slots[nextSlot];
+        if (slot.fence != 0)
+        {
+            current->framesDropped++;
+            return;
+        }
+
+        GLsizeiptr size = (GLsizeiptr)width * height * 4;
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        if (slot.size != size)
+        {
+            glBufferData(GL_PIXEL_PACK_BUFFER, size, NULL, GL_STREAM_READ);
+            slot.size = size;
+        }
+
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+        glReadBuffer(GL_BACK);
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glReadPixels(x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        slot.session = current;
+        slot.width = width;
+        slot.height = height;
+        slot.index = ++frameIndex;
+        slot.time = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+        inFlight.push_back(nextSlot);
+        nextSlot = (nextSlot + 1) % slots.size();
+    }
+
+private:
+    // Archivos y contadores de una sesion. Los cuadros en vuelo y en cola la mantienen viva, asi que
+    // se cierra (y se informa el total) cuando el ultimo cuadro pendiente se termino de escribir.
+    struct Session {
+        std::string prefix;
+        CaptureFormat format = CaptureFormat::PNG_SEQUENCE;
+        std::atomic<unsigned long> framesWritten{ 0 };
+        std::atomic<unsigned long> framesDropped{ 0 };
+
+        // solo video: lo usa unicamente el hilo de video
+        std::ofstream video;
+        int videoWidth = 0;
+        int videoHeight = 0;
+        double videoStart = 0.0;
+        long long nextVideoFrame = 0;
+        std::vector<unsigned char> videoFrame;  // ultimo cuadro YUV escrito, se repite para rellenar huecos
+
+        ~Session()
+        {
+            std::cout << "Capture finished: " << prefix << ", " << framesWritten << " frames written, " << framesDropped << " dropped" << std::endl;
+        }
+    };
+
+    struct Slot {
+        GLuint pbo = 0;
+        GLsync fence = 0;
+        GLsizeiptr size = 0;
+        std::shared_ptr<Session> session;
+        int width = 0;
+        int height = 0;
+        unsigned long index = 0;
+        double time = 0.0;
+    };
+
+    struct CapturedFrame {
+        std::shared_ptr<Session> session;
+        std::vector<unsigned char> pixels;   // RGBA, de abajo hacia arriba (como lo entrega OpenGL)
+        int width;
+        int height;
+        unsigned long index;
+        double time;        // segundos, reloj monotono
+    };
+
+    // tasa fija del video .y4m
+    static const int VIDEO_FPS = 60;
+
+    // cuadros que pueden esperar en cola antes de empezar a descartar (~70 MB a 2200x1000)
+    static const size_t MAX_QUEUED_FRAMES = 8;
+
+    std::string name;
+    std::string outputDir;
+    std::shared_ptr<Session> current;
+    long long lastSession = 0;
+
+    std::vector<Slot> slots;
+    std::deque<size_t> inFlight;
+    size_t nextSlot = 0;
+    unsigned long frameIndex = 0;
+
+    // los PNG se escriben en paralelo; los cuadros de video deben escribirse en orden, asi que tienen un solo hilo
+    std::vector<std::thread> pngWorkers;
+    std::thread videoWorker;
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    std::deque<CapturedFrame> pngQueue;
+    std::deque<CapturedFrame> videoQueue;
+    std::vector<std::vector<unsigned char>> freeBuffers;
+    bool stopping = false;
+
+    void startWorkers(CaptureFormat captureFormat)
+    {
+        if (captureFormat == CaptureFormat::Y4M_VIDEO)
+        {
+            if (!videoWorker.joinable())
+                videoWorker = std::thread(&FrameCapture::workerLoop, this, &videoQueue);
+            return;
+        }
+        if (!pngWorkers.empty())
+            return;
+        unsigned int cores = std::thread::hardware_concurrency();
+        unsigned int workerCount = cores > 3 ? (cores - 2 < 4 ? cores - 2 : 4) : 1;
+        for (unsigned int i = 0; i < workerCount; i++)
+            pngWorkers.emplace_back(&FrameCapture::workerLoop, this, &pngQueue);
+    }
+
+    // mapea las lecturas cuyo fence ya se cumplio, sin bloquear (timeout 0)
+    void collectReady()
+    {
+        while (!inFlight.empty())
+        {
+            Slot& slot = slots[inFlight.front()];
+            GLenum status = glClientWaitSync(slot.fence, 0, 0);
+            if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+                break;
+            readBack(slot);
+            inFlight.pop_front();
+        }
+    }
+
+    void readBack(Slot& slot)
+    {
+        glDeleteSync(slot.fence);
+        slot.fence = 0;
+        std::shared_ptr<Session> session = std::move(slot.session);
+
+        std::vector<unsigned char> pixels;
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            if (pngQueue.size() + videoQueue.size() >= MAX_QUEUED_FRAMES)
+            {
+                // el disco no alcanza: se descarta en vez de frenar el render
+                session->framesDropped++;
+                return;
+            }
+            if (!freeBuffers.empty())
+            {
+                pixels.swap(freeBuffers.back());
+                freeBuffers.pop_back();
+            }
+        }
+        pixels.resize((size_t)slot.size);
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, slot.size, GL_MAP_READ_BIT);
+        if (data)
+        {
+            std::memcpy(pixels.data(), data, (size_t)slot.size);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        if (!data)
+        {
+            session->framesDropped++;
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            std::deque<CapturedFrame>& queue = session->format == CaptureFormat::Y4M_VIDEO ? videoQueue : pngQueue;
+            queue.push_back(CapturedFrame{ std::move(session), std::move(pixels), slot.width, slot.height, slot.index, slot.time });
+        }
+        queueCondition.notify_all();
+    }
+
+    // espera a que se escriba todo lo que esta en cola y termina los hilos
+    void finishWorkers()
+    {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            stopping = true;
+        }
+        queueCondition.notify_all();
+        for (std::thread& worker : pngWorkers)
+            worker.join();
+        pngWorkers.clear();
+        if (videoWorker.joinable())
+            videoWorker.join();
+        stopping = false;
+    }
+
+    void workerLoop(std::deque<CapturedFrame>* queue)
+    {
+        for (;;)
+        {
+            CapturedFrame frame;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                queueCondition.wait(lock, [this, queue] { return stopping || !queue->empty(); });
+                if (queue->empty())
+                    return;
+                frame = std::move(queue->front());
+                queue->pop_front();
+            }
+
+            Session& session = *frame.session;
+            int written = session.format == CaptureFormat::Y4M_VIDEO ? writeVideoFrame(session, frame) : (writePng(session, frame) ? 1 : -1);
+            if (written >= 0)
+                session.framesWritten += written;
+            else
+                session.framesDropped++;
+
+            {
+                std::lock_guard<std::mutex> lock(queueMutex);
+                freeBuffers.push_back(std::move(frame.pixels));
+            }
+            // si era el ultimo cuadro de una sesion detenida, aqui se cierra su archivo
+            frame.session.reset();
+        }
+    }
+
+    // PNG
+    // ---
+    // sin zlib en el proyecto: se usan bloques deflate sin compresion (tipo 0), que son
+    // rapidos de escribir y validos para cualquier visor
+    bool writePng(const Session& session, const CapturedFrame& frame)
+    {
+        char suffix[32];
+        std::snprintf(suffix, sizeof(suffix), "_%06lu.png", frame.index);
+        std::ofstream file(session.prefix + suffix, std::ios::binary);
+        if (!file)
+            return false;
+
+        // filas RGB con byte de filtro 0, invirtiendo el eje Y
+        size_t rowSize = (size_t)frame.width * 3 + 1;
+        std::vector<unsigned char> raw(rowSize * frame.height);
+        for (int row = 0; row < frame.height; row++)
+        {
+            const unsigned char* src = frame.pixels.data() + (size_t)(frame.height - 1 - row) * frame.width * 4;
+            unsigned char* dst = raw.data() + row * rowSize;
+            *dst++ = 0;
+            for (int col = 0; col < frame.width; col++, src += 4)
+            {
+                *dst++ = src[0];
+                *dst++ = src[1];
+                *dst++ = src[2];
+            }
+        }
+
+        std::vector<unsigned char> zlib;
+        zlib.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+        zlib.push_back(0x78);
+        zlib.push_back(0x01);
+        for (size_t offset = 0;;)
+        {
+            size_t length = raw.size() - offset < 65535 ? raw.size() - offset : 65535;
+            bool last = offset + length == raw.size();
+            zlib.push_back(last ? 1 : 0);
+            zlib.push_back(length & 0xFF);
+            zlib.push_back((length >> 8) & 0xFF);
+            zlib.push_back(~length & 0xFF);
+            zlib.push_back((~length >> 8) & 0xFF);
+            zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + length);
+            offset += length;
+            if (last)
+                break;
+        }
+        putBigEndian(zlib, adler32(raw.data(), raw.size()));
+
+        static const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        file.write((const char*)signature, 8);
+
+        std::vector<unsigned char> header;
+        putBigEndian(header, (uint32_t)frame.width);
+        putBigEndian(header, (uint32_t)frame.height);
+        header.push_back(8);   // bits por canal
+        header.push_back(2);   // RGB
+        header.push_back(0);
+        header.push_back(0);
+        header.push_back(0);
+        writeChunk(file, "IHDR", header);
+        writeChunk(file, "IDAT", zlib);
+        writeChunk(file, "IEND", std::vector<unsigned char>());
+        return (bool)file;
+    }
+
+    static void putBigEndian(std::vector<unsigned char>& out, uint32_t value)
+    {
+        out.push_back((value >> 24) & 0xFF);
+        out.push_back((value >> 16) & 0xFF);
+        out.push_back((value >> 8) & 0xFF);
+        out.push_back(value & 0xFF);
+    }
+
+    static void writeChunk(std::ofstream& file, const char* type, const std::vector<unsigned char>& data)
+    {
+        std::vector<unsigned char> length;
+        putBigEndian(length, (uint32_t)data.size());
+        file.write((const char*)length.data(), 4);
+        file.write(type, 4);
+        if (!data.empty())
+            file.write((const char*)data.data(), data.size());
+
+        uint32_t crc = crc32(0xFFFFFFFFu, (const unsigned char*)type, 4);
+        crc = crc32(crc, data.data(), data.size()) ^ 0xFFFFFFFFu;
+        std::vector<unsigned char> crcBytes;
+        putBigEndian(crcBytes, crc);
+        file.write((const char*)crcBytes.data(), 4);
+    }
+
+    static uint32_t crc32(uint32_t crc, const unsigned char* data, size_t size)
+    {
+        static const std::vector<uint32_t> table = [] {
+            std::vector<uint32_t> t(256);
+            for (uint32_t n = 0; n < 256; n++)
+            {
+                uint32_t c = n;
+                for (int k = 0; k < 8; k++)
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                t[n] = c;
+            }
+            return t;
+        }();
+        for (size_t i = 0; i < size; i++)
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        return crc;
+    }
+
+    static uint32_t adler32(const unsigned char* data, size_t size)
+    {
+        uint32_t a = 1, b = 0;
+        while (size > 0)
+        {
+            size_t block = size < 5552 ? size : 5552;
+            size -= block;
+            while (block--)
+            {
+                a += *data++;
+                b += a;
+            }
+            a %= 65521;
+            b %= 65521;
+        }
+        return (b << 16) | a;
+    }
+
+    // Video Y4M
+    // ---------
+    // un solo hilo escribe el archivo, asi que los cuadros llegan en orden.
+    // Devuelve cuantos cuadros FRAME se escribieron (0 si se omitio) o -1 si hubo error.
+    int writeVideoFrame(Session& session, const CapturedFrame& frame)
+    {
+        if (!session.video.is_open())
+        {
+            session.video.open(session.prefix + ".y4m", std::ios::binary);
+            if (!session.video)
+                return -1;
+            session.videoWidth = frame.width;
+            session.videoHeight = frame.height;
+            session.videoStart = frame.time;
+            session.video << "YUV4MPEG2 W" << session.videoWidth << " H" << session.videoHeight << " F" << VIDEO_FPS << ":1 Ip A1:1 C420jpeg\n";
+        }
+        // el tamano del video es fijo: los cuadros de otro tamano (ventana redimensionada) se descartan
+        if (frame.width != session.videoWidth || frame.height != session.videoHeight)
+            return -1;
+
+        // posicion del cuadro en el video segun la hora de captura
+        long long target = std::llround((frame.time - session.videoStart) * VIDEO_FPS);
+        if (target < session.nextVideoFrame)
+            return 0;   // el render va mas rapido que el video: ese cuadro ya esta escrito
+
+        // cuadros que faltan (render lento o cuadros descartados): se repite el anterior
+        int written = 0;
+        for (; session.nextVideoFrame < target && !session.videoFrame.empty(); session.nextVideoFrame++, written++)
+        {
+            session.video << "FRAME\n";
+            session.video.write((const char*)session.videoFrame.data(), session.videoFrame.size());
+        }
+
+        int w = frame.width, h = frame.height;
+        int cw = (w + 1) / 2, ch = (h + 1) / 2;
+        std::vector<unsigned char>& yuv = session.videoFrame;
+        yuv.resize((size_t)w * h + (size_t)cw * ch * 2);
+        unsigned char* planeY = yuv.data();
+        unsigned char* planeU = planeY + (size_t)w * h;
+        unsigned char* planeV = planeU + (size_t)cw * ch;
+
+        // BT.601 rango limitado, con la imagen invertida en Y
+        for (int row = 0; row < h; row++)
+        {
+            const unsigned char* src = frame.pixels.data() + (size_t)(h - 1 - row) * w * 4;
+            for (int col = 0; col < w; col++, src += 4)
+                planeY[(size_t)row * w + col] = (unsigned char)(((66 * src[0] + 129 * src[1] + 25 * src[2] + 128) >> 8) + 16);
+        }
+        for (int row = 0; row < ch; row++)
+        {
+            for (int col = 0; col < cw; col++)
+            {
+                int r = 0, g = 0, b = 0, count = 0;
+                for (int dy = 0; dy < 2; dy++)
+                {
+                    int y = row * 2 + dy;
+                    if (y >= h)
+                        continue;
+                    for (int dx = 0; dx < 2; dx++)
+                    {
+                        int x = col * 2 + dx;
+                        if (x >= w)
+                            continue;
+                        const unsigned char* p = frame.pixels.data() + ((size_t)(h - 1 - y) * w + x) * 4;
+                        r += p[0];
+                        g += p[1];
+                        b += p[2];
+                        count++;
+                    }
+                }
+                r /= count;
+                g /= count;
+                b /= count;
+                planeU[(size_t)row * cw + col] = (unsigned char)(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+                planeV[(size_t)row * cw + col] = (unsigned char)(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+            }
+        }
+
+        session.video << "FRAME\n";
+        session.video.write((const char*)yuv.data(), yuv.size());
+        session.nextVideoFrame = target + 1;
+        return session.video ? written + 1 : -1;
+    }
+};
+
+#endif
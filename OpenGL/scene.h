@@ -0,0 +1,674 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <learnopengl/shader.h>
+#include <learnopengl/model.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// JSON
+// ----
+// lector minimo para el archivo de escena (objetos, arreglos, numeros, cadenas, true/false/null)
+struct JsonValue {
+    enum Type { NUL, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT };
+
+    Type type = NUL;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> array;
+    std::vector<std::pair<std::string, JsonValue>> object;
+
+    const JsonValue* find(const std::string& key) const
+    {
+        for (const auto& member : object)
+            if (member.first == key)
+                return &member.second;
+        return NULL;
+    }
+
+    float getFloat(const std::string& key, float fallback) const
+    {
+        const JsonValue* value = find(key);
+        if (value == NULL)
+            return fallback;
+        if (value->type != NUMBER)
+            throw std::runtime_error("\"" + key + "\" must be a number");
+        return (float)value->number;
+    }
+
+    std::string getString(const std::string& key, const std::string& fallback) const
+    {
+        const JsonValue* value = find(key);
+        if (value == NULL)
+            return fallback;
+        if (value->type != STRING)
+            throw std::runtime_error("\"" + key + "\" must be a string");
+        return value->string;
+    }
+
+    glm::vec3 getVec3(const std::string& key, const glm::vec3& fallback) const
+    {
+        const JsonValue* value = find(key);
+        return value == NULL ? fallback : value->toVec3(key);
+    }
+
+    glm::vec3 toVec3(const std::string& name) const
+    {
+        if (type != ARRAY || array.size() != 3 || array[0].type != NUMBER || array[1].type != NUMBER || array[2].type != NUMBER)
+            throw std::runtime_error("\"" + name + "\" must be an array of 3 numbers");
+        return glm::vec3((float)array[0].number, (float)array[1].number, (float)array[2].number);
+    }
+};
+
+class JsonParser
+{
+public:
+    static JsonValue parse(const std::string& text)
+    {
+        JsonParser parser(text);
+        JsonValue value = parser.parseValue();
+        parser.skipWhitespace();
+        if (parser.position != text.size())
+            parser.fail("unexpected data after the end of the document");
+        return value;
+    }
+
+private:
+    const std::string& text;
+    size_t position = 0;
+
+    explicit JsonParser(const std::string& text) : text(text) {}
+
+    [[noreturn]] void fail(const std::string& message) const
+    {
+        size_t line = 1;
+        for (size_t i = 0; i < position && i < text.size(); i++)
+            if (text[i] == '\n')
+                line++;
+        throw std::runtime_error("line " + std::to_string(line) + ": " + message);
+    }
+
+    void skipWhitespace()
+    {
+        while (position < text.size() && (text[position] == ' ' || text[position] == '\t' || text[position] == '\n' || text[position] == '\r'))
+            position++;
+    }
+
+    void expect(char c)
+    {
+        skipWhitespace();
+        if (position >= text.size() || text[position] != c)
+            fail(std::string("expected '") + c + "'");
+        position++;
+    }
+
+    bool consume(const char* word)
+    {
+        size_t length = std::char_traits<char>::length(word);
+        if (text.compare(position, length, word) != 0)
+            return false;
+        position += length;
+        return true;
+    }
+
+    JsonValue parseValue()
+    {
+        skipWhitespace();
+        if (position >= text.size())
+            fail("unexpected end of file");
+
+        JsonValue value;
+        char c = text[position];
+        if (c == '{')
+        {
+            value.type = JsonValue::OBJECT;
+            position++;
+            skipWhitespace();
+            if (position < text.size() && text[position] == '}')
+            {
+                position++;
+                return value;
+            }
+            for (;;)
+            {
+                skipWhitespace();
+                if (position >= text.size() || text[position] != '"')
+                    fail("expected a member name");
+                std::string key = parseString();
+                expect(':');
+                value.object.emplace_back(key, parseValue());
+                skipWhitespace();
+                if (position < text.size() && text[position] == ',')
+                {
+                    position++;
+                    continue;
+                }
+                expect('}');
+                return value;
+            }
+        }
+        if (c == '[')
+        {
+            value.type = JsonValue::ARRAY;
+            position++;
+            skipWhitespace();
+            if (position < text.size() && text[position] == ']')
+            {
+                position++;
+                return value;
+            }
+            for (;;)
+            {
+                value.array.push_back(parseValue());
+                skipWhitespace();
+                if (position < text.size() && text[position] == ',')
+                {
+                    position++;
+                    continue;
+                }
+                expect(']');
+                return value;
+            }
+        }
+        if (c == '"')
+        {
+            value.type = JsonValue::STRING;
+            value.string = parseString();
+            return value;
+        }
+        if (consume("true"))
+        {
+            value.type = JsonValue::BOOLEAN;
+            value.boolean = true;
+            return value;
+        }
+        if (consume("false"))
+        {
+            value.type = JsonValue::BOOLEAN;
+            return value;
+        }
+        if (consume("null"))
+            return value;
+
+        const char* start = text.c_str() + position;
+        char* end = NULL;
+        value.number = std::strtod(start, &end);
+        if (end == start)
+            fail("unexpected character");
+        value.type = JsonValue::NUMBER;
+        position += end - start;
+        return value;
+    }
+
+    std::string parseString()
+    {
+        position++;
+        std::string result;
+        while (position < text.size() && text[position] != '"')
+        {
+            char c = text[position++];
+            if (c == '\\' && position < text.size())
+            {
+                char escaped = text[position++];
+                switch (escaped)
+                {
+                case 'n': result += '\n'; break;
+                case 't': result += '\t'; break;
+                case 'r': result += '\r'; break;
+                case 'b': result += '\b'; break;
+                case 'f': result += '\f'; break;
+                case 'u': fail("\\u escapes are not supported");
+                default: result += escaped; break;
+                }
+            }
+            else
+            {
+                result += c;
+            }
+        }
+        if (position >= text.size())
+            fail("unterminated string");
+        position++;
+        return result;
+    }
+};
+
+// Transformaciones
+// ----------------
+// Estructura de arreglos: cada componente en su propio vector contiguo. Las matrices de mundo de los
+// nodos estaticos se calculan una sola vez (o cuando se marcan como sucias); cada cuadro solo se
+// recorren los nodos animados de los grupos visibles.
+enum class Animation : unsigned char {
+    NONE,
+    BOB,    // sube y baja: y += amplitude * sin(speed * t)
+    SPIN    // gira sobre Y a speed grados por segundo
+};
+
+struct TransformStore {
+    std::vector<glm::vec3> position;
+    std::vector<glm::vec3> rotation;    // grados, se aplica Y, luego X, luego Z
+    std::vector<glm::vec3> scale;
+    std::vector<glm::mat4> world;
+    std::vector<unsigned char> dirty;
+    std::vector<unsigned int> dirtyNodes;
+
+    // nodos animados, en arreglos paralelos
+    std::vector<unsigned int> animatedNodes;
+    std::vector<int> animatedGroup;     // grupo de la instancia, -1: siempre visible
+    std::vector<Animation> animation;
+    std::vector<float> amplitude;
+    std::vector<float> speed;
+
+    size_t size() const { return position.size(); }
+
+    unsigned int add(const glm::vec3& nodePosition, const glm::vec3& nodeRotation, const glm::vec3& nodeScale)
+    {
+        unsigned int node = (unsigned int)position.size();
+        position.push_back(nodePosition);
+        rotation.push_back(nodeRotation);
+        scale.push_back(nodeScale);
+        world.push_back(glm::mat4(1.0f));
+        dirty.push_back(0);
+        markDirty(node);
+        return node;
+    }
+
+    void animate(unsigned int node, int group, Animation type, float nodeAmplitude, float nodeSpeed)
+    {
+        animatedNodes.push_back(node);
+        animatedGroup.push_back(group);
+        animation.push_back(type);
+        amplitude.push_back(nodeAmplitude);
+        speed.push_back(nodeSpeed);
+    }
+
+    void setPosition(unsigned int node, const glm::vec3& nodePosition)
+    {
+        position[node] = nodePosition;
+        markDirty(node);
+    }
+
+    void markDirty(unsigned int node)
+    {
+        if (!dirty[node])
+        {
+            dirty[node] = 1;
+            dirtyNodes.push_back(node);
+        }
+    }
+
+    // los nodos animados de grupos ocultos no se recalculan: se actualizan el primer cuadro en que vuelven a verse
+    void update(float time, const std::vector<unsigned char>& groupVisible)
+    {
+        for (unsigned int node : dirtyNodes)
+        {
+            world[node] = compose(position[node], rotation[node], scale[node]);
+            dirty[node] = 0;
+        }
+        dirtyNodes.clear();
+
+        for (size_t i = 0; i < animatedNodes.size(); i++)
+        {
+            if (animatedGroup[i] >= 0 && !groupVisible[animatedGroup[i]])
+                continue;
+            unsigned int node = animatedNodes[i];
+            glm::vec3 nodePosition = position[node];
+            glm::vec3 nodeRotation = rotation[node];
+            if (animation[i] == Animation::BOB)
+                nodePosition.y += amplitude[i] * sin(speed[i] * time);
+            else if (animation[i] == Animation::SPIN)
+                nodeRotation.y += speed[i] * time;
+            world[node] = compose(nodePosition, nodeRotation, scale[node]);
+        }
+    }
+
+    static glm::mat4 compose(const glm::vec3& nodePosition, const glm::vec3& nodeRotation, const glm::vec3& nodeScale)
+    {
+        glm::mat4 model = glm::mat4(1.0f);
+        model = glm::translate(model, nodePosition);
+        if (nodeRotation.y != 0.0f)
+            model = glm::rotate(model, glm::radians(nodeRotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
+        if (nodeRotation.x != 0.0f)
+            model = glm::rotate(model, glm::radians(nodeRotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
+        if (nodeRotation.z != 0.0f)
+            model = glm::rotate(model, glm::radians(nodeRotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
+        return glm::scale(model, nodeScale);
+    }
+};
+
+// Escena
+// ------
+struct SceneLight {
+    std::string uniform;    // nombre del PointLight en el fragment shader
+    glm::vec3 position;
+    glm::vec3 ambient, diffuse, specular;
+    bool hasFlash = false;  // valores alternos (la luna durante los fuegos artificiales)
+    glm::vec3 flashAmbient, flashDiffuse, flashSpecular;
+    float constant, linear, quadratic;
+};
+
+struct CameraPreset {
+    int key;                // tecla numerica 0-9
+    glm::vec3 position;
+    glm::vec3 front;
+};
+
+struct FireworkShow {
+    std::vector<Model*> models;
+    std::vector<float> delays;                      // retraso de cada modelo dentro de una fase
+    std::vector<std::vector<glm::vec3>> phases;     // posiciones de cada modelo en cada fase
+    float phaseDuration = 4.0f;
+    float initialSize = 0.1f;
+    float growth = 0.2f;                            // crecimiento de la escala por fase
+};
+
+struct SceneColliders {
+    glm::vec3 skydomeCenter;
+    float skydomeRadius;
+    float skydomeMaxHeight;
+    glm::vec3 stadiumMin, stadiumMax;
+    glm::vec3 fieldMin, fieldMax;
+};
+
+// Escena descrita en un archivo JSON: modelos, instancias, luces, camaras predefinidas, fuegos
+// artificiales y colisiones del estadio. El archivo se vuelve a leer al guardarlo; los modelos ya
+// cargados se conservan y solo se cargan las rutas nuevas. Si el archivo tiene errores se mantiene
+// la escena anterior.
+class Scene
+{
+public:
+    std::vector<SceneLight> lights;
+    std::vector<CameraPreset> cameraPresets;
+    FireworkShow fireworks;
+    SceneColliders colliders;
+
+    bool load(const std::string& scenePath)
+    {
+        path = scenePath;
+        loadedTime = modificationTime();
+
+        std::ifstream file(path);
+        if (!file)
+        {
+            std::cout << "ERROR::SCENE::FILE_NOT_SUCCESFULLY_READ: " << path << std::endl;
+            return false;
+        }
+        std::stringstream stream;
+        stream << file.rdbuf();
+
+        try
+        {
+            Scene parsed;
+            parsed.parse(JsonParser::parse(stream.str()), modelCache);
+            lights = std::move(parsed.lights);
+            cameraPresets = std::move(parsed.cameraPresets);
+            fireworks = std::move(parsed.fireworks);
+            colliders = parsed.colliders;
+            transforms = std::move(parsed.transforms);
+            instanceModel = std::move(parsed.instanceModel);
+            instanceGroup = std::move(parsed.instanceGroup);
+            groupNames = std::move(parsed.groupNames);
+            groupVisible = std::move(parsed.groupVisible);
+            assets = std::move(parsed.assets);
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << "ERROR::SCENE::PARSE_ERROR " << path << ": " << e.what() << std::endl;
+            return false;
+        }
+
+        // se liberan los modelos que la escena nueva ya no usa
+        for (auto entry = modelCache.begin(); entry != modelCache.end();)
+        {
+            bool used = false;
+            for (const auto& sceneAsset : assets)
+                used = used || sceneAsset.second == entry->second.get();
+            entry = used ? std::next(entry) : modelCache.erase(entry);
+        }
+        return true;
+    }
+
+    // revisa la fecha del archivo cada medio segundo; true si la escena se recargo
+    bool reloadIfChanged(double time)
+    {
+        if (time - lastCheck < 0.5)
+            return false;
+        lastCheck = time;
+
+        std::filesystem::file_time_type current = modificationTime();
+        if (current == loadedTime || current == std::filesystem::file_time_type::min())
+            return false;
+        if (!load(path))
+            return false;
+        std::cout << "Scene reloaded: " << path << std::endl;
+        return true;
+    }
+
+    // recalcula solo las matrices sucias y las de los nodos animados visibles;
+    // llamar despues de setGroupVisible() y antes de draw()
+    void update(float time)
+    {
+        transforms.update(time, groupVisible);
+    }
+
+    void setGroupVisible(const std::string& group, bool visible)
+    {
+        for (size_t i = 0; i < groupNames.size(); i++)
+            if (groupNames[i] == group)
+                groupVisible[i] = visible;
+    }
+
+    void draw(Shader& shader)
+    {
+        for (size_t i = 0; i < transforms.size(); i++)
+        {
+            if (instanceGroup[i] >= 0 && !groupVisible[instanceGroup[i]])
+                continue;
+            shader.setMat4("model", transforms.world[i]);
+            instanceModel[i]->Draw(shader);
+        }
+    }
+
+private:
+    std::string path;
+    std::filesystem::file_time_type loadedTime;
+    double lastCheck = 0.0;
+
+    // modelos por ruta; se conservan entre recargas para no volver a leerlos del disco, y los que la
+    // escena deja de usar se liberan
+    std::map<std::string, std::unique_ptr<Model>> modelCache;
+    std::map<std::string, Model*> assets;
+
+    TransformStore transforms;
+    std::vector<Model*> instanceModel;
+    std::vector<int> instanceGroup;     // -1: siempre visible
+    std::vector<std::string> groupNames;
+    std::vector<unsigned char> groupVisible;
+
+    std::filesystem::file_time_type modificationTime() const
+    {
+        std::error_code error;
+        std::filesystem::file_time_type time = std::filesystem::last_write_time(path, error);
+        return error ? std::filesystem::file_time_type::min() : time;
+    }
+
+    Model* asset(const std::string& name) const
+    {
+        auto found = assets.find(name);
+        if (found == assets.end())
+            throw std::runtime_error("unknown asset \"" + name + "\"");
+        return found->second;
+    }
+
+    static const JsonValue& member(const JsonValue& value, const std::string& key, JsonValue::Type type)
+    {
+        const JsonValue* found = value.find(key);
+        if (found == NULL)
+            throw std::runtime_error("missing \"" + key + "\"");
+        if (found->type != type)
+            throw std::runtime_error("\"" + key + "\" has the wrong type");
+        return *found;
+    }
+
+    void parse(const JsonValue& root, std::map<std::string, std::unique_ptr<Model>>& cache)
+    {
+        if (root.type != JsonValue::OBJECT)
+            throw std::runtime_error("the scene must be a JSON object");
+
+        // assets: nombre -> ruta del modelo
+        for (const auto& entry : member(root, "assets", JsonValue::OBJECT).object)
+        {
+            if (entry.second.type != JsonValue::STRING)
+                throw std::runtime_error("asset \"" + entry.first + "\" must be a path");
+            auto cached = cache.find(entry.second.string);
+            if (cached == cache.end())
+            {
+                // Model no lanza excepciones si Assimp falla: solo imprime el error y queda sin meshes.
+                // No se guarda en el cache, asi la siguiente recarga lo vuelve a intentar.
+                std::unique_ptr<Model> model(new Model(entry.second.string));
+                if (model->meshes.empty())
+                    throw std::runtime_error("asset \"" + entry.first + "\" could not be loaded from " + entry.second.string);
+                cached = cache.emplace(entry.second.string, std::move(model)).first;
+            }
+            assets[entry.first] = cached->second.get();
+        }
+
+        for (const JsonValue& instance : member(root, "instances", JsonValue::ARRAY).array)
+        {
+            unsigned int node = transforms.add(instance.getVec3("position", glm::vec3(0.0f)),
+                                               instance.getVec3("rotation", glm::vec3(0.0f)),
+                                               instance.getVec3("scale", glm::vec3(1.0f)));
+            instanceModel.push_back(asset(instance.getString("asset", "")));
+
+            std::string group = instance.getString("group", "");
+            int groupIndex = -1;
+            if (!group.empty())
+            {
+                for (size_t i = 0; i < groupNames.size(); i++)
+                    if (groupNames[i] == group)
+                        groupIndex = (int)i;
+                if (groupIndex < 0)
+                {
+                    groupIndex = (int)groupNames.size();
+                    groupNames.push_back(group);
+                    groupVisible.push_back(0);
+                }
+            }
+            instanceGroup.push_back(groupIndex);
+
+            const JsonValue* animation = instance.find("animation");
+            if (animation != NULL)
+            {
+                std::string type = animation->getString("type", "");
+                if (type == "bob")
+                    transforms.animate(node, groupIndex, Animation::BOB, animation->getFloat("amplitude", 0.05f), animation->getFloat("speed", 10.0f));
+                else if (type == "spin")
+                    transforms.animate(node, groupIndex, Animation::SPIN, 0.0f, animation->getFloat("speed", 45.0f));
+                else
+                    throw std::runtime_error("unknown animation \"" + type + "\"");
+            }
+        }
+
+        for (const JsonValue& light : member(root, "lights", JsonValue::ARRAY).array)
+        {
+            SceneLight sceneLight;
+            sceneLight.uniform = light.getString("uniform", "");
+            sceneLight.position = light.getVec3("position", glm::vec3(0.0f));
+            sceneLight.ambient = light.getVec3("ambient", glm::vec3(0.1f));
+            sceneLight.diffuse = light.getVec3("diffuse", glm::vec3(0.4f));
+            sceneLight.specular = light.getVec3("specular", glm::vec3(1.0f));
+            sceneLight.constant = light.getFloat("constant", 1.0f);
+            sceneLight.linear = light.getFloat("linear", 0.09f);
+            sceneLight.quadratic = light.getFloat("quadratic", 0.032f);
+            const JsonValue* flash = light.find("flash");
+            if (flash != NULL)
+            {
+                sceneLight.hasFlash = true;
+                sceneLight.flashAmbient = flash->getVec3("ambient", sceneLight.ambient);
+                sceneLight.flashDiffuse = flash->getVec3("diffuse", sceneLight.diffuse);
+                sceneLight.flashSpecular = flash->getVec3("specular", sceneLight.specular);
+            }
+            lights.push_back(sceneLight);
+        }
+
+        for (const JsonValue& preset : member(root, "cameraPresets", JsonValue::ARRAY).array)
+        {
+            CameraPreset cameraPreset;
+            cameraPreset.key = (int)preset.getFloat("key", -1.0f);
+            if (cameraPreset.key < 0 || cameraPreset.key > 9)
+                throw std::runtime_error("camera preset keys must be between 0 and 9");
+            cameraPreset.position = member(preset, "position", JsonValue::ARRAY).toVec3("position");
+            // la direccion se da directamente ("front") o como un punto al que mirar ("target")
+            if (preset.find("target") != NULL)
+                cameraPreset.front = glm::normalize(preset.getVec3("target", glm::vec3(0.0f)) - cameraPreset.position);
+            else
+                cameraPreset.front = glm::normalize(member(preset, "front", JsonValue::ARRAY).toVec3("front"));
+            cameraPresets.push_back(cameraPreset);
+        }
+
+        const JsonValue& show = member(root, "fireworks", JsonValue::OBJECT);
+        for (const JsonValue& name : member(show, "assets", JsonValue::ARRAY).array)
+        {
+            if (name.type != JsonValue::STRING)
+                throw std::runtime_error("fireworks assets must be asset names");
+            fireworks.models.push_back(asset(name.string));
+        }
+        for (const JsonValue& delay : member(show, "delays", JsonValue::ARRAY).array)
+        {
+            if (delay.type != JsonValue::NUMBER)
+                throw std::runtime_error("fireworks delays must be numbers");
+            fireworks.delays.push_back((float)delay.number);
+        }
+        for (const JsonValue& phase : member(show, "phases", JsonValue::ARRAY).array)
+        {
+            if (phase.type != JsonValue::ARRAY)
+                throw std::runtime_error("each fireworks phase must be an array of positions");
+            std::vector<glm::vec3> positions;
+            for (const JsonValue& position : phase.array)
+                positions.push_back(position.toVec3("phases"));
+            if (positions.size() != fireworks.models.size())
+                throw std::runtime_error("each fireworks phase needs one position per asset");
+            fireworks.phases.push_back(positions);
+        }
+        if (fireworks.delays.size() != fireworks.models.size())
+            throw std::runtime_error("fireworks needs one delay per asset");
+        // se divide entre la duracion para saber la fase actual
+        fireworks.phaseDuration = show.getFloat("phaseDuration", 4.0f);
+        if (!(fireworks.phaseDuration > 0.0f))
+            throw std::runtime_error("\"phaseDuration\" must be greater than 0");
+        fireworks.initialSize = show.getFloat("initialSize", 0.1f);
+        fireworks.growth = show.getFloat("growth", 0.2f);
+
+        const JsonValue& collision = member(root, "colliders", JsonValue::OBJECT);
+        const JsonValue& skydome = member(collision, "skydome", JsonValue::OBJECT);
+        colliders.skydomeCenter = skydome.getVec3("center", glm::vec3(0.0f));
+        colliders.skydomeRadius = skydome.getFloat("radius", 19.3f);
+        colliders.skydomeMaxHeight = skydome.getFloat("maxHeight", colliders.skydomeRadius);
+        const JsonValue& stadium = member(collision, "stadium", JsonValue::OBJECT);
+        colliders.stadiumMin = member(stadium, "min", JsonValue::ARRAY).toVec3("min");
+        colliders.stadiumMax = member(stadium, "max", JsonValue::ARRAY).toVec3("max");
+        const JsonValue& field = member(collision, "field", JsonValue::OBJECT);
+        colliders.fieldMin = member(field, "min", JsonValue::ARRAY).toVec3("min");
+        colliders.fieldMax = member(field, "max", JsonValue::ARRAY).toVec3("max");
+    }
+};
+
+#endif
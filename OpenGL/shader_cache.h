@@ -0,0 +1,471 @@
+#ifndef SHADER_CACHE_H
+#define SHADER_CACHE_H
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// GL_ARB_get_program_binary es core desde OpenGL 4.1; el contexto es 3.3, asi que se carga a mano
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+// Cache en disco de programas enlazados (glGetProgramBinary / glProgramBinary).
+// La clave es un hash del codigo fuente de ambos shaders y del driver (vendor, renderer, version),
+// de modo que un cambio en el shader o una actualizacion del driver invalida el binario.
+// Si el driver rechaza el binario se vuelve a compilar desde el codigo fuente.
+// Cada programa recuerda su archivo, para borrar con discard() los binarios de versiones reemplazadas.
+class ShaderCache
+{
+public:
+    explicit ShaderCache(const std::string& cacheDir) : cacheDir(cacheDir)
+    {
+        getProgramBinary = (GetProgramBinaryFn)glfwGetProcAddress("glGetProgramBinary");
+        programBinary = (ProgramBinaryFn)glfwGetProcAddress("glProgramBinary");
+        programParameteri = (ProgramParameteriFn)glfwGetProcAddress("glProgramParameteri");
+
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        while (glGetError() != GL_NO_ERROR) {}
+        enabled = getProgramBinary && programBinary && programParameteri && formats > 0;
+
+        driver = std::string((const char*)glGetString(GL_VENDOR)) + "|" +
+                 (const char*)glGetString(GL_RENDERER) + "|" +
+                 (const char*)glGetString(GL_VERSION);
+
+        if (!enabled)
+            std::cout << "Shader cache disabled: driver does not support program binaries" << std::endl;
+    }
+
+    static bool readSource(const std::string& path, std::string& source)
+    {
+        std::ifstream file(path);
+        if (!file)
+        {
+            std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ: " << path << std::endl;
+            return false;
+        }
+        std::stringstream stream;
+        stream << file.rdbuf();
+        source = stream.str();
+        return true;
+    }
+
+    // programa enlazado a partir de los archivos; 0 si no se pudo leer o compilar
+    GLuint load(const std::string& vertexPath, const std::string& fragmentPath)
+    {
+        std::string vertexCode, fragmentCode;
+        if (!readSource(vertexPath, vertexCode) || !readSource(fragmentPath, fragmentCode))
+            return 0;
+        return build(vertexCode, fragmentCode);
+    }
+
+    // se puede llamar desde cualquier hilo con un contexto compartido activo
+    GLuint build(const std::string& vertexCode, const std::string& fragmentCode)
+    {
+        std::string path = binaryPath(vertexCode, fragmentCode);
+        if (enabled)
+        {
+            GLuint program = loadBinary(path);
+            if (program != 0)
+            {
+                remember(program, path);
+                return program;
+            }
+        }
+
+        GLuint program = compile(vertexCode, fragmentCode);
+        if (program != 0 && enabled && saveBinary(program, path))
+            remember(program, path);
+        return program;
+    }
+
+    // el programa se va a borrar porque una version nueva lo reemplazo: su binario ya no sirve.
+    // El archivo se conserva si otro programa vivo usa el mismo (p. ej. el shader se guardo sin cambios).
+    void discard(GLuint program)
+    {
+        std::lock_guard<std::mutex> lock(binariesMutex);
+        auto found = binaries.find(program);
+        if (found == binaries.end())
+            return;
+        std::string path = found->second;
+        binaries.erase(found);
+        for (const auto& binary : binaries)
+            if (binary.second == path)
+                return;
+        std::error_code error;
+        std::filesystem::remove(path, error);
+    }
+
+private:
+    typedef void (APIENTRYP GetProgramBinaryFn)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+    typedef void (APIENTRYP ProgramBinaryFn)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+    typedef void (APIENTRYP ProgramParameteriFn)(GLuint program, GLenum pname, GLint value);
+
+    // cabecera de cada archivo del cache: "SPB1", formato del binario, longitud
+    static const uint32_t MAGIC = 0x31425053;
+
+    std::string cacheDir;
+    std::string driver;
+    bool enabled = false;
+    GetProgramBinaryFn getProgramBinary = NULL;
+    ProgramBinaryFn programBinary = NULL;
+    ProgramParameteriFn programParameteri = NULL;
+
+    // programa -> archivo del cache; build() se llama desde el hilo principal y el de recarga
+    std::mutex binariesMutex;
+    std::map<GLuint, std::string> binaries;
+
+    void remember(GLuint program, const std::string& path)
+    {
+        std::lock_guard<std::mutex> lock(binariesMutex);
+        binaries[program] = path;
+    }
+
+    std::string binaryPath(const std::string& vertexCode, const std::string& fragmentCode) const
+    {
+        // FNV-1a de 64 bits
+        uint64_t hash = 14695981039346656037ull;
+        auto mix = [&hash](const std::string& text) {
+            for (unsigned char c : text)
+            {
+                hash ^= c;
+                hash *= 1099511628211ull;
+            }
+            hash ^= 0xFF;
+            hash *= 1099511628211ull;
+        };
+        mix(vertexCode);
+        mix(fragmentCode);
+        mix(driver);
+
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)hash);
+        return (std::filesystem::path(cacheDir) / name).string();
+    }
+
+    GLuint loadBinary(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            return 0;
+
+        uint32_t header[3];
+        if (!file.read((char*)header, sizeof(header)) || header[0] != MAGIC)
+            return 0;
+        // la longitud de la cabecera debe coincidir con lo que queda del archivo (archivo truncado o corrupto)
+        std::error_code error;
+        uintmax_t fileSize = std::filesystem::file_size(path, error);
+        if (error || header[2] == 0 || fileSize != sizeof(header) + (uintmax_t)header[2])
+            return 0;
+        std::vector<char> data(header[2]);
+        if (!file.read(data.data(), data.size()))
+            return 0;
+
+        GLuint program = glCreateProgram();
+        programBinary(program, header[1], data.data(), (GLsizei)data.size());
+        GLint success = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        if (!success)
+        {
+            // binario de otro driver o corrupto: se recompila y se sobreescribe
+            glDeleteProgram(program);
+            return 0;
+        }
+        return program;
+    }
+
+    bool saveBinary(GLuint program, const std::string& path)
+    {
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0)
+            return false;
+        std::vector<char> data(length);
+        GLenum format = 0;
+        getProgramBinary(program, length, NULL, &format, data.data());
+
+        std::error_code error;
+        std::filesystem::create_directories(cacheDir, error);
+
+        // se escribe a un temporal y se renombra para no dejar binarios a medias
+        std::string temporary = path + ".tmp";
+        std::ofstream file(temporary, std::ios::binary);
+        uint32_t header[3] = { MAGIC, (uint32_t)format, (uint32_t)length };
+        file.write((const char*)header, sizeof(header));
+        file.write(data.data(), data.size());
+        file.close();
+        if (file.fail())
+        {
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+        std::filesystem::rename(temporary, path, error);
+        if (error)
+        {
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+        return true;
+    }
+
+    GLuint compile(const std::string& vertexCode, const std::string& fragmentCode)
+    {
+        const char* vShaderCode = vertexCode.c_str();
+        const char* fShaderCode = fragmentCode.c_str();
+
+        GLuint vertex = glCreateShader(GL_VERTEX_SHADER);
+        glShaderSource(vertex, 1, &vShaderCode, NULL);
+        glCompileShader(vertex);
+        bool vertexOk = checkCompileErrors(vertex, "VERTEX");
+
+        GLuint fragment = glCreateShader(GL_FRAGMENT_SHADER);
+        glShaderSource(fragment, 1, &fShaderCode, NULL);
+        glCompileShader(fragment);
+        bool fragmentOk = checkCompileErrors(fragment, "FRAGMENT");
+
+        GLuint program = 0;
+        if (vertexOk && fragmentOk)
+        {
+            program = glCreateProgram();
+            if (enabled)
+                programParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+            glAttachShader(program, vertex);
+            glAttachShader(program, fragment);
+            glLinkProgram(program);
+            if (!checkCompileErrors(program, "PROGRAM"))
+            {
+                glDeleteProgram(program);
+                program = 0;
+            }
+        }
+        glDeleteShader(vertex);
+        glDeleteShader(fragment);
+        return program;
+    }
+
+    static bool checkCompileErrors(GLuint shader, const std::string& type)
+    {
+        GLint success;
+        GLchar infoLog[1024];
+        if (type != "PROGRAM")
+        {
+            glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+            if (!success)
+            {
+                glGetShaderInfoLog(shader, 1024, NULL, infoLog);
+                std::cout << "ERROR::SHADER_COMPILATION_ERROR of type: " << type << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
+            }
+        }
+        else
+        {
+            glGetProgramiv(shader, GL_LINK_STATUS, &success);
+            if (!success)
+            {
+                glGetProgramInfoLog(shader, 1024, NULL, infoLog);
+                std::cout << "ERROR::PROGRAM_LINKING_ERROR of type: " << type << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
+            }
+        }
+        return success != 0;
+    }
+};
+
+// Recarga en caliente de shaders.
+// Un hilo revisa la fecha de modificacion de los archivos y recompila en un contexto compartido
+// (ventana oculta), asi el render no se detiene ni se recargan los modelos. El programa nuevo
+// solo se cambia en apply(), en el hilo principal y entre cuadros; si no compila, se conserva el anterior.
+class ShaderHotReload
+{
+public:
+    ShaderHotReload(GLFWwindow* mainWindow, ShaderCache& cache) : cache(cache)
+    {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        sharedWindow = glfwCreateWindow(1, 1, "shader reload", NULL, mainWindow);
+        glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+        if (sharedWindow == NULL)
+            std::cout << "ERROR::SHADER_RELOAD::SHARED_CONTEXT_NOT_CREATED (hot reload disabled)" << std::endl;
+    }
+
+    // shutdown() debe llamarse antes de glfwTerminate; aqui solo se detiene el hilo
+    ~ShaderHotReload()
+    {
+        stopThread();
+    }
+
+    // vigila el par de archivos; el programa en programId (p. ej. Shader::ID) se reemplaza en apply()
+    void watch(unsigned int& programId, const std::string& vertexPath, const std::string& fragmentPath)
+    {
+        if (sharedWindow == NULL)
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            Entry entry;
+            entry.programId = &programId;
+            entry.vertexPath = vertexPath;
+            entry.fragmentPath = fragmentPath;
+            entry.vertexTime = modificationTime(vertexPath);
+            entry.fragmentTime = modificationTime(fragmentPath);
+            entries.push_back(entry);
+        }
+        if (!worker.joinable())
+            worker = std::thread(&ShaderHotReload::workerLoop, this);
+    }
+
+    // hilo principal, una vez por cuadro: instala los programas recompilados.
+    // Devuelve true si hubo cambio (los uniforms del programa nuevo deben configurarse de nuevo).
+    bool apply()
+    {
+        if (!hasPending)
+            return false;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        bool changed = false;
+        for (Entry& entry : entries)
+        {
+            if (entry.pending == 0)
+                continue;
+            cache.discard(*entry.programId);
+            glDeleteProgram(*entry.programId);
+            *entry.programId = entry.pending;
+            entry.pending = 0;
+            changed = true;
+        }
+        hasPending = false;
+        return changed;
+    }
+
+    void shutdown()
+    {
+        stopThread();
+        if (sharedWindow != NULL)
+        {
+            glfwDestroyWindow(sharedWindow);
+            sharedWindow = NULL;
+        }
+    }
+
+private:
+    struct Entry {
+        unsigned int* programId = NULL;
+        std::string vertexPath;
+        std::string fragmentPath;
+        std::filesystem::file_time_type vertexTime;
+        std::filesystem::file_time_type fragmentTime;
+        GLuint pending = 0;
+    };
+
+    ShaderCache& cache;
+    GLFWwindow* sharedWindow = NULL;
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::deque<Entry> entries;
+    std::atomic<bool> hasPending{ false };
+    bool stopping = false;
+
+    static std::filesystem::file_time_type modificationTime(const std::string& path)
+    {
+        std::error_code error;
+        std::filesystem::file_time_type time = std::filesystem::last_write_time(path, error);
+        return error ? std::filesystem::file_time_type::min() : time;
+    }
+
+    void stopThread()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeUp.notify_all();
+        if (worker.joinable())
+            worker.join();
+    }
+
+    void workerLoop()
+    {
+        glfwMakeContextCurrent(sharedWindow);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!wakeUp.wait_for(lock, std::chrono::milliseconds(250), [this] { return stopping; }))
+        {
+            for (size_t i = 0; i < entries.size(); i++)
+            {
+                std::string vertexPath = entries[i].vertexPath;
+                std::string fragmentPath = entries[i].fragmentPath;
+                lock.unlock();
+
+                std::filesystem::file_time_type vertexTime = modificationTime(vertexPath);
+                std::filesystem::file_time_type fragmentTime = modificationTime(fragmentPath);
+
+                lock.lock();
+                Entry& entry = entries[i];
+                if (vertexTime == entry.vertexTime && fragmentTime == entry.fragmentTime)
+                    continue;
+                // un archivo que no existe (el editor lo esta reemplazando) se revisa en la siguiente vuelta
+                if (vertexTime == std::filesystem::file_time_type::min() || fragmentTime == std::filesystem::file_time_type::min())
+                    continue;
+                entry.vertexTime = vertexTime;
+                entry.fragmentTime = fragmentTime;
+                lock.unlock();
+
+                GLuint program = cache.load(vertexPath, fragmentPath);
+                if (program != 0)
+                {
+                    // el programa debe estar completo antes de usarlo desde el otro contexto
+                    glFinish();
+                    std::cout << "Shader reloaded: " << vertexPath << ", " << fragmentPath << std::endl;
+                }
+                else
+                {
+                    std::cout << "Shader reload failed, keeping previous program: " << vertexPath << ", " << fragmentPath << std::endl;
+                }
+
+                lock.lock();
+                if (program != 0)
+                {
+                    if (entries[i].pending != 0)
+                    {
+                        cache.discard(entries[i].pending);
+                        glDeleteProgram(entries[i].pending);
+                    }
+                    entries[i].pending = program;
+                    hasPending = true;
+                }
+            }
+        }
+
+        // programas que ya no se instalaran
+        for (Entry& entry : entries)
+        {
+            if (entry.pending != 0)
+                glDeleteProgram(entry.pending);
+            entry.pending = 0;
+        }
+        lock.unlock();
+        glfwMakeContextCurrent(NULL);
+    }
+};
+
+#endif
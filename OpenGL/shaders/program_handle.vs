@@ -0,0 +1,6 @@
+#version 330 core
+// Programa minimo: solo da un ID valido al Shader de learnopengl, que luego usa el programa del cache
+void main()
+{
+    gl_Position = vec4(0.0, 0.0, 0.0, 1.0);
+}
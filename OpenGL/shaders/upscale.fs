@@ -0,0 +1,48 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoords;
+
+uniform sampler2D sourceTexture;
+uniform vec2 textureSize;   // tamano completo de la textura (ventana)
+uniform vec2 renderSize;    // parte de la textura donde se dibujo la escena
+
+// muestra en coordenadas de texel, sin salir de la zona dibujada
+vec3 fetch(vec2 texelPos)
+{
+    texelPos = clamp(texelPos, vec2(0.5), renderSize - 0.5);
+    return texture(sourceTexture, texelPos / textureSize).rgb;
+}
+
+// Catmull-Rom bicubico con 9 lecturas bilineales en lugar de 16
+void main()
+{
+    vec2 samplePos = TexCoords * renderSize;
+    vec2 texPos1 = floor(samplePos - 0.5) + 0.5;
+    vec2 f = samplePos - texPos1;
+
+    vec2 w0 = f * (-0.5 + f * (1.0 - 0.5 * f));
+    vec2 w1 = 1.0 + f * f * (-2.5 + 1.5 * f);
+    vec2 w2 = f * (0.5 + f * (2.0 - 1.5 * f));
+    vec2 w3 = f * f * (-0.5 + 0.5 * f);
+
+    vec2 w12 = w1 + w2;
+    vec2 texPos0 = texPos1 - 1.0;
+    vec2 texPos3 = texPos1 + 2.0;
+    vec2 texPos12 = texPos1 + w2 / w12;
+
+    vec3 result = vec3(0.0);
+    result += fetch(vec2(texPos0.x, texPos0.y)) * w0.x * w0.y;
+    result += fetch(vec2(texPos12.x, texPos0.y)) * w12.x * w0.y;
+    result += fetch(vec2(texPos3.x, texPos0.y)) * w3.x * w0.y;
+
+    result += fetch(vec2(texPos0.x, texPos12.y)) * w0.x * w12.y;
+    result += fetch(vec2(texPos12.x, texPos12.y)) * w12.x * w12.y;
+    result += fetch(vec2(texPos3.x, texPos12.y)) * w3.x * w12.y;
+
+    result += fetch(vec2(texPos0.x, texPos3.y)) * w0.x * w3.y;
+    result += fetch(vec2(texPos12.x, texPos3.y)) * w12.x * w3.y;
+    result += fetch(vec2(texPos3.x, texPos3.y)) * w3.x * w3.y;
+
+    FragColor = vec4(clamp(result, 0.0, 1.0), 1.0);
+}